@@ -0,0 +1,258 @@
+#ifndef ATTACKS_H
+#define ATTACKS_H
+
+#include "bitboard.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+//         .
+//  - ""  (       
+//  ),  PEXT,    BMI2.
+//        ,
+//     .
+
+constexpr Bitboard RookMagicNumbers[SQUARE_NB] = {
+    0x8080102040008000ULL, 0x5440041000200048ULL, 0x008020008010000AULL, 0x0200084200100420ULL,
+    0x0200081020040200ULL, 0x0600019002002824ULL, 0x040050811008020CULL, 0x0100004881000126ULL,
+    0x0005800440008020ULL, 0x2882002042090880ULL, 0x0002802000801004ULL, 0x0240808010000800ULL,
+    0x4480800800040082ULL, 0x0408808004000200ULL, 0x00BA0004A8020001ULL, 0x1106000042040091ULL,
+    0x0020208010400080ULL, 0x0022060045028020ULL, 0x0020008020100080ULL, 0x0202020008102041ULL,
+    0x0C50808008000400ULL, 0x0068808002000400ULL, 0x00510400C8100201ULL, 0x400006000100A444ULL,
+    0x483424818008400AULL, 0x8840008080200040ULL, 0x0800100080802000ULL, 0x0440100080800800ULL,
+    0x4000080080040080ULL, 0x9124040080020080ULL, 0x0089000300040E00ULL, 0x080001020020488CULL,
+    0x9040002040800080ULL, 0x80D0002001400242ULL, 0x0000401901002002ULL, 0x0030220901001000ULL,
+    0x0080580005003100ULL, 0x0022006C0A001008ULL, 0x0802301144001248ULL, 0x0020010042000084ULL,
+    0x4AC0400084228004ULL, 0x0010004020004000ULL, 0x3110004020010100ULL, 0x0598100009050020ULL,
+    0x4200080011010004ULL, 0x0818020004008080ULL, 0x02A0708102040008ULL, 0x5201010080420004ULL,
+    0x100B124063800100ULL, 0x7808200240048980ULL, 0x8800200010008080ULL, 0x1099201001000900ULL,
+    0x0100050010080100ULL, 0x0400800200040080ULL, 0x2040280190020400ULL, 0x00100C0100608200ULL,
+    0x0000201241088202ULL, 0x1040002042801B01ULL, 0x0124090010200041ULL, 0x0831002004081001ULL,
+    0x2003000800021005ULL, 0x80010002040008C1ULL, 0x0208008122081004ULL, 0x4000008844002102ULL
+};
+
+constexpr Bitboard BishopMagicNumbers[SQUARE_NB] = {
+    0x0020011019010028ULL, 0x0122100912208000ULL, 0x1498082308200080ULL, 0x0004106600000000ULL,
+    0x2082021000405600ULL, 0x68508804C0820201ULL, 0xA004140422080010ULL, 0x0120402084202004ULL,
+    0x0000F0101014C080ULL, 0x014002300A022041ULL, 0x000084080A004020ULL, 0x2061949202010083ULL,
+    0x0407820210050008ULL, 0x00500101084008A2ULL, 0x2000040404420880ULL, 0x00090044041C0710ULL,
+    0x0804004030841140ULL, 0x002580A001240100ULL, 0x2081000214090200ULL, 0x0812022C01220050ULL,
+    0x0602001012100010ULL, 0x0003004080454024ULL, 0x0000400088084800ULL, 0x8000800040480850ULL,
+    0x1010040110602230ULL, 0x8428204002044D32ULL, 0x0340240028880200ULL, 0x1804080018220040ULL,
+    0x0C10101041004001ULL, 0x0422208008080100ULL, 0x0010810610941000ULL, 0x0302122002050140ULL,
+    0x8304104008054400ULL, 0x1000AC5003A45026ULL, 0x0202402080100508ULL, 0xC801042008040100ULL,
+    0x00400020210A0080ULL, 0x4010404200004104ULL, 0x0401180120008C00ULL, 0x0811450200110052ULL,
+    0xB10110825000A020ULL, 0x8104008405001050ULL, 0x0908094050030803ULL, 0x000414C204800804ULL,
+    0x2000202414004042ULL, 0x044001040020A100ULL, 0x0008100400440082ULL, 0x210101050A040102ULL,
+    0x8004442420080000ULL, 0x0906008421080000ULL, 0x0220208048081004ULL, 0x0000004084240800ULL,
+    0x00080020A0864200ULL, 0x40010484880E0000ULL, 0x9040100440808008ULL, 0x0010028089020002ULL,
+    0x100082004202C000ULL, 0x4049051042022000ULL, 0x010100010C110400ULL, 0x8200000B02208810ULL,
+    0x0000001008210100ULL, 0x0000180410241840ULL, 0x0880100401680A01ULL, 0x04021A0809040081ULL
+};
+
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+};
+
+const int ROOK_TABLE_SIZE = 102400;
+const int BISHOP_TABLE_SIZE = 5248;
+
+inline Magic RookMagics[SQUARE_NB];
+inline Magic BishopMagics[SQUARE_NB];
+inline Bitboard RookTable[ROOK_TABLE_SIZE];
+inline Bitboard BishopTable[BISHOP_TABLE_SIZE];
+
+inline Bitboard KnightAttacks[SQUARE_NB];
+inline Bitboard KingAttacks[SQUARE_NB];
+inline Bitboard PawnAttacks[2][SQUARE_NB];
+
+//       ,  0
+inline Bitboard BetweenBB[SQUARE_NB][SQUARE_NB];
+//      (   ),  0
+inline Bitboard LineBB[SQUARE_NB][SQUARE_NB];
+
+inline bool UsePext = false;
+
+inline bool cpuHasBMI2() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 8)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int a, b, c, d;
+    if (!__get_cpuid_count(7, 0, &a, &b, &c, &d)) return false;
+    return (b & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#define HAS_PEXT 1
+inline uint64_t pext(uint64_t b, uint64_t mask) {
+    return _pext_u64(b, mask);
+}
+#elif defined(__GNUC__) && defined(__x86_64__)
+#define HAS_PEXT 1
+__attribute__((target("bmi2"))) inline uint64_t pext(uint64_t b, uint64_t mask) {
+    return __builtin_ia32_pext_di(b, mask);
+}
+#else
+#define HAS_PEXT 0
+inline uint64_t pext(uint64_t b, uint64_t mask) {
+    uint64_t result = 0;
+    for (uint64_t bit = 1; mask; bit <<= 1) {
+        if (b & mask & (0 - mask)) result |= bit;
+        mask &= mask - 1;
+    }
+    return result;
+}
+#endif
+
+inline unsigned magicIndex(const Magic& m, Bitboard occupied) {
+    if (UsePext) {
+        return (unsigned)pext(occupied, m.mask);
+    }
+    return (unsigned)(((occupied & m.mask) * m.magic) >> m.shift);
+}
+
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    const Magic& m = RookMagics[sq];
+    return m.attacks[magicIndex(m, occupied)];
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    const Magic& m = BishopMagics[sq];
+    return m.attacks[magicIndex(m, occupied)];
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+//   ,     
+inline Bitboard slidingAttacks(int sq, Bitboard occupied, const int directions[4][2]) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < 4; i++) {
+        int x = (sq & 7) + directions[i][0];
+        int y = (sq >> 3) + directions[i][1];
+        while (x >= 0 && x < 8 && y >= 0 && y < 8) {
+            Bitboard b = squareBB(makeSquare(x, y));
+            attacks |= b;
+            if (occupied & b) break;
+            x += directions[i][0];
+            y += directions[i][1];
+        }
+    }
+    return attacks;
+}
+
+inline void initMagics(Magic magics[], Bitboard table[], const Bitboard numbers[], const int directions[4][2]) {
+    Bitboard* next = table;
+    for (int sq = 0; sq < SQUARE_NB; sq++) {
+        //       
+        Bitboard edges = ((RANK_1_BB | RANK_8_BB) & ~(RANK_1_BB << (8 * (sq >> 3)))) |
+            ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << (sq & 7)));
+
+        Magic& m = magics[sq];
+        m.mask = slidingAttacks(sq, 0, directions) & ~edges;
+        m.magic = numbers[sq];
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = next;
+
+        //     (Carry-Rippler)
+        Bitboard occupied = 0;
+        do {
+            m.attacks[magicIndex(m, occupied)] = slidingAttacks(sq, occupied, directions);
+            occupied = (occupied - m.mask) & m.mask;
+        } while (occupied);
+
+        next += 1ULL << popCount(m.mask);
+    }
+}
+
+inline void initStepAttacks() {
+    const int knightSteps[8][2] = {
+        {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
+        {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
+    };
+
+    for (int sq = 0; sq < SQUARE_NB; sq++) {
+        int x = sq & 7, y = sq >> 3;
+        KnightAttacks[sq] = KingAttacks[sq] = 0;
+        PawnAttacks[0][sq] = PawnAttacks[1][sq] = 0;
+
+        for (int i = 0; i < 8; i++) {
+            int nx = x + knightSteps[i][0], ny = y + knightSteps[i][1];
+            if (nx >= 0 && nx < 8 && ny >= 0 && ny < 8) {
+                KnightAttacks[sq] |= squareBB(makeSquare(nx, ny));
+            }
+        }
+
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                int nx = x + dx, ny = y + dy;
+                if ((dx || dy) && nx >= 0 && nx < 8 && ny >= 0 && ny < 8) {
+                    KingAttacks[sq] |= squareBB(makeSquare(nx, ny));
+                }
+            }
+        }
+
+        for (int dx = -1; dx <= 1; dx += 2) {
+            int nx = x + dx;
+            if (nx < 0 || nx >= 8) continue;
+            if (y < 7) PawnAttacks[0][sq] |= squareBB(makeSquare(nx, y + 1));
+            if (y > 0) PawnAttacks[1][sq] |= squareBB(makeSquare(nx, y - 1));
+        }
+    }
+}
+
+inline void initBetween() {
+    for (int a = 0; a < SQUARE_NB; a++) {
+        for (int b = 0; b < SQUARE_NB; b++) {
+            Bitboard ab = squareBB(a) | squareBB(b);
+            BetweenBB[a][b] = LineBB[a][b] = 0;
+            if (a == b) continue;
+
+            if (rookAttacks(a, 0) & squareBB(b)) {
+                BetweenBB[a][b] = rookAttacks(a, ab) & rookAttacks(b, ab);
+                LineBB[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | ab;
+            }
+            else if (bishopAttacks(a, 0) & squareBB(b)) {
+                BetweenBB[a][b] = bishopAttacks(a, ab) & bishopAttacks(b, ab);
+                LineBB[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | ab;
+            }
+        }
+    }
+}
+
+inline bool initAttacks() {
+    const int rookDirections[4][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };
+    const int bishopDirections[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+    UsePext = HAS_PEXT && cpuHasBMI2();
+    initStepAttacks();
+    initMagics(RookMagics, RookTable, RookMagicNumbers, rookDirections);
+    initMagics(BishopMagics, BishopTable, BishopMagicNumbers, bishopDirections);
+    initBetween();
+    return true;
+}
+
+//    , 
+inline void ensureAttacksInitialized() {
+    static const bool initialized = initAttacks();
+    (void)initialized;
+}
+
+#endif // ATTACKS_H
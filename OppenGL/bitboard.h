@@ -0,0 +1,134 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+typedef uint64_t Bitboard;
+
+enum class PieceColor {
+    WHITE,
+    BLACK
+};
+
+struct Position {
+    int x, y;
+    Position(int x = 0, int y = 0) : x(x), y(y) {}
+    bool operator==(const Position& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+//  ,  -   
+enum Capability : uint8_t {
+    CAP_ROOK = 1 << 0,
+    CAP_BISHOP = 1 << 1,
+    CAP_KNIGHT = 1 << 2,
+    CAP_PAWN = 1 << 3,
+    CAP_KING = 1 << 4,
+    CAP_COUNT = 5
+};
+
+//    :  0-4 ,  5 
+typedef uint8_t PieceCode;
+const PieceCode NO_PIECE = 0;
+const int PIECE_CODE_NB = 64;
+
+const int SQUARE_NB = 64;
+const int NO_SQUARE = 64;
+
+const Bitboard FILE_A_BB = 0x0101010101010101ULL;
+const Bitboard FILE_H_BB = FILE_A_BB << 7;
+const Bitboard RANK_1_BB = 0xFFULL;
+const Bitboard RANK_8_BB = RANK_1_BB << 56;
+
+inline int colorIndex(PieceColor color) {
+    return static_cast<int>(color);
+}
+
+inline PieceCode makePieceCode(PieceColor color, uint8_t caps) {
+    return PieceCode(caps | (colorIndex(color) << 5));
+}
+
+inline uint8_t pieceCaps(PieceCode code) {
+    return code & 31;
+}
+
+inline PieceColor pieceColor(PieceCode code) {
+    return (code & 32) ? PieceColor::BLACK : PieceColor::WHITE;
+}
+
+inline int makeSquare(int x, int y) {
+    return y * 8 + x;
+}
+
+inline int makeSquare(const Position& pos) {
+    return makeSquare(pos.x, pos.y);
+}
+
+inline Position squareToPosition(int sq) {
+    return Position(sq & 7, sq >> 3);
+}
+
+inline Bitboard squareBB(int sq) {
+    return 1ULL << sq;
+}
+
+inline int popCount(Bitboard b) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    return (int)__popcnt64(b);
+#elif defined(_MSC_VER)
+    return (int)(__popcnt((unsigned int)b) + __popcnt((unsigned int)(b >> 32)));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+//    , b != 0
+inline int lsb(Bitboard b) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long idx;
+    _BitScanForward64(&idx, b);
+    return (int)idx;
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if ((unsigned int)b) {
+        _BitScanForward(&idx, (unsigned int)b);
+        return (int)idx;
+    }
+    _BitScanForward(&idx, (unsigned int)(b >> 32));
+    return (int)idx + 32;
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+//    , b != 0
+inline int msb(Bitboard b) {
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, b);
+    return (int)idx;
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if ((unsigned int)(b >> 32)) {
+        _BitScanReverse(&idx, (unsigned int)(b >> 32));
+        return (int)idx + 32;
+    }
+    _BitScanReverse(&idx, (unsigned int)b);
+    return (int)idx;
+#else
+    return 63 - __builtin_clzll(b);
+#endif
+}
+
+inline int popLsb(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+#endif // BITBOARD_H
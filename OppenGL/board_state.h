@@ -0,0 +1,469 @@
+#ifndef BOARD_STATE_H
+#define BOARD_STATE_H
+
+#include <cstring>
+
+#include "bitboard.h"
+#include "attacks.h"
+#include "move.h"
+#include "zobrist.h"
+#include "psqt.h"
+
+enum CastlingRight : uint8_t {
+    WHITE_OO = 1,
+    WHITE_OOO = 2,
+    BLACK_OO = 4,
+    BLACK_OOO = 8
+};
+
+//  ,     O(1)
+struct UndoRecord {
+    Bitboard unmoved;
+    PieceCode moved;
+    PieceCode captured;
+    uint8_t castling;
+    uint8_t epSquare;
+    uint8_t rule50;
+    uint64_t key;
+    uint64_t pawnKey;
+    uint64_t materialKey;
+};
+
+//   :      
+//   .      
+//  ( -    ),   
+//   .     
+// putPiece/removePiece/movePiece   .
+struct BoardState {
+    Bitboard byColor[2];
+    Bitboard byCap[CAP_COUNT];
+    Bitboard unmoved;
+    PieceCode mailbox[SQUARE_NB];
+    uint8_t sideToMove;
+    uint8_t castling;
+    uint8_t epSquare;
+    uint8_t rule50;
+    uint16_t gamePly;
+
+    //      putPiece/removePiece/movePiece
+    //  make;  -    ,  -  
+    //   ,    
+    uint64_t key;
+    uint64_t pawnKey;
+    uint64_t materialKey;
+
+    //  +   (/ ,  )  
+    // ,   ,  
+    PackedScore psqt;
+    int16_t phase;
+
+    BoardState() {
+        clear();
+    }
+
+    //            
+    void clear() {
+        std::memset(this, 0, sizeof(BoardState));
+        epSquare = NO_SQUARE;
+    }
+
+    PieceColor side() const {
+        return sideToMove ? PieceColor::BLACK : PieceColor::WHITE;
+    }
+
+    PieceCode pieceOn(int sq) const {
+        return mailbox[sq];
+    }
+
+    bool isEmpty(int sq) const {
+        return mailbox[sq] == NO_PIECE;
+    }
+
+    Bitboard occupied() const {
+        return byColor[0] | byColor[1];
+    }
+
+    Bitboard pieces(PieceColor color) const {
+        return byColor[colorIndex(color)];
+    }
+
+    //      (    )
+    Bitboard piecesWith(Capability cap) const {
+        return byCap[capIndex(cap)];
+    }
+
+    Bitboard piecesWith(PieceColor color, Capability cap) const {
+        return byCap[capIndex(cap)] & byColor[colorIndex(color)];
+    }
+
+    //    : ,       
+    Bitboard piecesOf(PieceCode code) const {
+        Bitboard result = byColor[colorIndex(pieceColor(code))];
+        uint8_t caps = pieceCaps(code);
+        for (int i = 0; i < CAP_COUNT; i++) {
+            result &= (caps & (1 << i)) ? byCap[i] : ~byCap[i];
+        }
+        return result;
+    }
+
+    //       ;
+    //     ( "")  
+    Bitboard royal(int color) const {
+        return byCap[capIndex(CAP_KING)] & byColor[color] &
+            ~(byCap[capIndex(CAP_ROOK)] | byCap[capIndex(CAP_BISHOP)] |
+              byCap[capIndex(CAP_KNIGHT)] | byCap[capIndex(CAP_PAWN)]);
+    }
+
+    //  ,     
+    Bitboard plainPawns(int color) const {
+        return byCap[capIndex(CAP_PAWN)] & byColor[color] &
+            ~(byCap[capIndex(CAP_ROOK)] | byCap[capIndex(CAP_BISHOP)] |
+              byCap[capIndex(CAP_KNIGHT)] | byCap[capIndex(CAP_KING)]);
+    }
+
+    //     -     ;  
+    //      - 
+    bool hasNonPawnMaterial(int color) const {
+        return (byColor[color] & ~plainPawns(color) & ~royal(color)) != 0;
+    }
+
+    int kingSquare(int color) const {
+        Bitboard kings = royal(color);
+        return kings ? lsb(kings) : NO_SQUARE;
+    }
+
+    //    ,     
+    Bitboard attackersTo(int sq, Bitboard occupied) const {
+        return (rookAttacks(sq, occupied) & byCap[capIndex(CAP_ROOK)])
+            | (bishopAttacks(sq, occupied) & byCap[capIndex(CAP_BISHOP)])
+            | (KnightAttacks[sq] & byCap[capIndex(CAP_KNIGHT)])
+            | (KingAttacks[sq] & byCap[capIndex(CAP_KING)])
+            | (PawnAttacks[0][sq] & byCap[capIndex(CAP_PAWN)] & byColor[1])
+            | (PawnAttacks[1][sq] & byCap[capIndex(CAP_PAWN)] & byColor[0]);
+    }
+
+    bool inCheck() const {
+        int ksq = kingSquare(sideToMove);
+        return ksq != NO_SQUARE && (attackersTo(ksq, occupied()) & byColor[sideToMove ^ 1]);
+    }
+
+    void putPiece(PieceCode code, int sq) {
+        Bitboard b = squareBB(sq);
+        mailbox[sq] = code;
+        key ^= Zobrist.psq[code][sq];
+        materialKey ^= Zobrist.material[code][popCount(piecesOf(code))];
+        psqt += PieceSquare[code][sq];
+        phase += PiecePhase[code];
+        byColor[colorIndex(pieceColor(code))] |= b;
+        uint8_t caps = pieceCaps(code);
+        if (caps == CAP_PAWN) {
+            pawnKey ^= Zobrist.psq[code][sq];
+        }
+        for (int i = 0; i < CAP_COUNT; i++) {
+            if (caps & (1 << i)) {
+                byCap[i] |= b;
+            }
+        }
+    }
+
+    void removePiece(int sq) {
+        PieceCode code = mailbox[sq];
+        if (code == NO_PIECE) return;
+
+        Bitboard b = squareBB(sq);
+        mailbox[sq] = NO_PIECE;
+        key ^= Zobrist.psq[code][sq];
+        materialKey ^= Zobrist.material[code][popCount(piecesOf(code)) - 1];
+        psqt -= PieceSquare[code][sq];
+        phase -= PiecePhase[code];
+        byColor[colorIndex(pieceColor(code))] &= ~b;
+        uint8_t caps = pieceCaps(code);
+        if (caps == CAP_PAWN) {
+            pawnKey ^= Zobrist.psq[code][sq];
+        }
+        for (int i = 0; i < CAP_COUNT; i++) {
+            if (caps & (1 << i)) {
+                byCap[i] &= ~b;
+            }
+        }
+    }
+
+    void movePiece(int from, int to) {
+        PieceCode code = mailbox[from];
+        removePiece(to);
+
+        Bitboard fromTo = squareBB(from) | squareBB(to);
+        mailbox[from] = NO_PIECE;
+        mailbox[to] = code;
+        byColor[colorIndex(pieceColor(code))] ^= fromTo;
+        uint64_t delta = Zobrist.psq[code][from] ^ Zobrist.psq[code][to];
+        key ^= delta;
+        psqt += PieceSquare[code][to] - PieceSquare[code][from];
+        uint8_t caps = pieceCaps(code);
+        if (caps == CAP_PAWN) {
+            pawnKey ^= delta;
+        }
+        for (int i = 0; i < CAP_COUNT; i++) {
+            if (caps & (1 << i)) {
+                byCap[i] ^= fromTo;
+            }
+        }
+    }
+
+    //      :   e-
+    //       ,    
+    void setCastlingFromSetup() {
+        key ^= Zobrist.castling[castling];
+        castling = 0;
+        for (int us = 0; us < 2; us++) {
+            int base = us == 0 ? 0 : 56;
+            if (mailbox[base + 4] != makePieceCode(PieceColor(us), CAP_KING) || !(unmoved & squareBB(base + 4))) {
+                continue;
+            }
+            Bitboard rooks = byCap[capIndex(CAP_ROOK)] & byColor[us] & unmoved;
+            if (rooks & squareBB(base + 7)) castling |= us == 0 ? WHITE_OO : BLACK_OO;
+            if (rooks & squareBB(base)) castling |= us == 0 ? WHITE_OOO : BLACK_OOO;
+        }
+        key ^= Zobrist.castling[castling];
+    }
+
+    void make(Move m, UndoRecord& undo) {
+        int from = fromSquare(m);
+        int to = toSquare(m);
+        int flags = moveFlags(m);
+        int us = sideToMove;
+        PieceCode piece = mailbox[from];
+
+        undo.unmoved = unmoved;
+        undo.moved = piece;
+        undo.captured = NO_PIECE;
+        undo.castling = castling;
+        undo.epSquare = epSquare;
+        undo.rule50 = rule50;
+        undo.key = key;
+        undo.pawnKey = pawnKey;
+        undo.materialKey = materialKey;
+
+        epSquare = NO_SQUARE;
+        rule50++;
+        gamePly++;
+
+        if (flags == FLAG_EP_CAPTURE) {
+            int capSq = us == 0 ? to - 8 : to + 8;
+            undo.captured = mailbox[capSq];
+            removePiece(capSq);
+        }
+        else if (flags & FLAG_CAPTURE) {
+            undo.captured = mailbox[to];
+            removePiece(to);
+        }
+
+        movePiece(from, to);
+
+        if (flags == FLAG_KING_CASTLE || flags == FLAG_QUEEN_CASTLE) {
+            int rookFrom = flags == FLAG_KING_CASTLE ? from + 3 : from - 4;
+            int rookTo = flags == FLAG_KING_CASTLE ? from + 1 : from - 1;
+            movePiece(rookFrom, rookTo);
+            unmoved &= ~squareBB(rookFrom);
+        }
+        else if (flags & FLAG_PROMOTION) {
+            removePiece(to);
+            putPiece(makePieceCode(PieceColor(us), promotionCaps(m)), to);
+        }
+        else if (flags == FLAG_DOUBLE_PUSH) {
+            //     ,     
+            int ep = (from + to) / 2;
+            if (PawnAttacks[us][ep] & byCap[capIndex(CAP_PAWN)] & byColor[us ^ 1]) {
+                epSquare = uint8_t(ep);
+            }
+        }
+
+        if (undo.captured != NO_PIECE || (pieceCaps(piece) & CAP_PAWN)) {
+            rule50 = 0;
+        }
+
+        castling &= CastlingMask[from] & CastlingMask[to];
+        unmoved &= ~(squareBB(from) | squareBB(to));
+        sideToMove ^= 1;
+
+        key ^= Zobrist.side ^ Zobrist.castling[undo.castling] ^ Zobrist.castling[castling];
+        if (undo.epSquare != NO_SQUARE) {
+            key ^= Zobrist.epFile[undo.epSquare & 7];
+        }
+        if (epSquare != NO_SQUARE) {
+            key ^= Zobrist.epFile[epSquare & 7];
+        }
+    }
+
+    void unmake(Move m, const UndoRecord& undo) {
+        int from = fromSquare(m);
+        int to = toSquare(m);
+        int flags = moveFlags(m);
+
+        sideToMove ^= 1;
+        gamePly--;
+        int us = sideToMove;
+
+        if (flags & FLAG_PROMOTION) {
+            removePiece(to);
+            putPiece(undo.moved, to);
+        }
+        else if (flags == FLAG_KING_CASTLE || flags == FLAG_QUEEN_CASTLE) {
+            int rookFrom = flags == FLAG_KING_CASTLE ? from + 3 : from - 4;
+            int rookTo = flags == FLAG_KING_CASTLE ? from + 1 : from - 1;
+            movePiece(rookTo, rookFrom);
+        }
+
+        movePiece(to, from);
+
+        if (flags == FLAG_EP_CAPTURE) {
+            putPiece(undo.captured, us == 0 ? to - 8 : to + 8);
+        }
+        else if (undo.captured != NO_PIECE) {
+            putPiece(undo.captured, to);
+        }
+
+        unmoved = undo.unmoved;
+        castling = undo.castling;
+        epSquare = undo.epSquare;
+        rule50 = undo.rule50;
+        key = undo.key;
+        pawnKey = undo.pawnKey;
+        materialKey = undo.materialKey;
+    }
+
+    //       
+    void makeNull(UndoRecord& undo) {
+        undo.epSquare = epSquare;
+        undo.rule50 = rule50;
+        undo.key = key;
+
+        if (epSquare != NO_SQUARE) {
+            key ^= Zobrist.epFile[epSquare & 7];
+            epSquare = NO_SQUARE;
+        }
+        key ^= Zobrist.side;
+        rule50++;
+        sideToMove ^= 1;
+    }
+
+    void unmakeNull(const UndoRecord& undo) {
+        sideToMove ^= 1;
+        epSquare = undo.epSquare;
+        rule50 = undo.rule50;
+        key = undo.key;
+    }
+
+    //       -   
+    //  ; ,      
+    //  ,    
+    uint64_t keyAfter(Move m) const {
+        int from = fromSquare(m);
+        int to = toSquare(m);
+        PieceCode piece = mailbox[from];
+        uint64_t result = key ^ Zobrist.side ^ Zobrist.psq[piece][from] ^ Zobrist.psq[piece][to];
+        if (mailbox[to] != NO_PIECE) {
+            result ^= Zobrist.psq[mailbox[to]][to];
+        }
+        if (epSquare != NO_SQUARE) {
+            result ^= Zobrist.epFile[epSquare & 7];
+        }
+        return result;
+    }
+
+    //    -     (FEN)   
+    // 
+    uint64_t computeKey() const {
+        uint64_t result = Zobrist.castling[castling];
+        Bitboard b = occupied();
+        while (b) {
+            int sq = popLsb(b);
+            result ^= Zobrist.psq[mailbox[sq]][sq];
+        }
+        if (epSquare != NO_SQUARE) {
+            result ^= Zobrist.epFile[epSquare & 7];
+        }
+        if (sideToMove) {
+            result ^= Zobrist.side;
+        }
+        return result;
+    }
+
+    uint64_t computePawnKey() const {
+        uint64_t result = 0;
+        Bitboard b = byCap[capIndex(CAP_PAWN)];
+        while (b) {
+            int sq = popLsb(b);
+            if (pieceCaps(mailbox[sq]) == CAP_PAWN) {
+                result ^= Zobrist.psq[mailbox[sq]][sq];
+            }
+        }
+        return result;
+    }
+
+    uint64_t computeMaterialKey() const {
+        uint64_t result = 0;
+        for (int code = 0; code < PIECE_CODE_NB; code++) {
+            int count = pieceCaps(PieceCode(code)) ? popCount(piecesOf(PieceCode(code))) : 0;
+            for (int i = 0; i < count; i++) {
+                result ^= Zobrist.material[code][i];
+            }
+        }
+        return result;
+    }
+
+    PackedScore computePsqt() const {
+        PackedScore result = 0;
+        Bitboard b = occupied();
+        while (b) {
+            int sq = popLsb(b);
+            result += PieceSquare[mailbox[sq]][sq];
+        }
+        return result;
+    }
+
+    int16_t computePhase() const {
+        int result = 0;
+        Bitboard b = occupied();
+        while (b) {
+            result += PiecePhase[mailbox[popLsb(b)]];
+        }
+        return int16_t(result);
+    }
+
+    void refreshKeys() {
+        key = computeKey();
+        pawnKey = computePawnKey();
+        materialKey = computeMaterialKey();
+    }
+
+    //     (setCapsValue/setCapsTable)
+    void refreshEval() {
+        psqt = computePsqt();
+        phase = computePhase();
+    }
+
+    static uint8_t promotionCaps(Move m) {
+        static const uint8_t caps[4] = { CAP_KNIGHT, CAP_BISHOP, CAP_ROOK, CAP_ROOK | CAP_BISHOP };
+        return caps[moveFlags(m) & 3];
+    }
+
+private:
+    //     /  
+    static constexpr uint8_t CastlingMask[SQUARE_NB] = {
+        13, 15, 15, 15, 12, 15, 15, 14,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+         7, 15, 15, 15,  3, 15, 15, 11
+    };
+
+    static int capIndex(Capability cap) {
+        return lsb(cap);
+    }
+};
+
+#endif // BOARD_STATE_H
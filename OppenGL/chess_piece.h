@@ -6,23 +6,15 @@
 #include <vector>
 #include <cmath>
 #include <string>
+#include <algorithm>
 
 #include <GLFW/glfw3.h>
 #include "shader.h"
 #include "stb_image.h"
-
-enum class PieceColor {
-    WHITE,
-    BLACK
-};
-
-struct Position {
-    int x, y;
-    Position(int x = 0, int y = 0) : x(x), y(y) {}
-    bool operator==(const Position& other) const {
-        return x == other.x && y == other.y;
-    }
-};
+#include "bitboard.h"
+#include "board_state.h"
+#include "attacks.h"
+#include "movegen.h"
 
 class ChessPiece
 {
@@ -32,12 +24,8 @@ protected:
     Position position;
     float renderX, renderY;
 
-    // 
-    bool canMoveAsRook;
-    bool canMoveAsBishop;
-    bool canMoveAsKnight;
-    bool canMoveAsPawn;
-    bool canMoveAsKing;
+    // ,  Capability
+    uint8_t capabilities;
     
     // 
     bool hasMoved;
@@ -50,9 +38,9 @@ public:
         bool rook = false, bool bishop = false, bool knight = false,
         bool pawn = false, bool king = false,
         const std::string& name = "Custom Piece")
-        : color(pieceColor), position(pos), canMoveAsRook(rook),
-        canMoveAsBishop(bishop), canMoveAsKnight(knight),
-        canMoveAsPawn(pawn), canMoveAsKing(king),
+        : color(pieceColor), position(pos),
+        capabilities((rook ? CAP_ROOK : 0) | (bishop ? CAP_BISHOP : 0) |
+            (knight ? CAP_KNIGHT : 0) | (pawn ? CAP_PAWN : 0) | (king ? CAP_KING : 0)),
         hasMoved(false), pieceName(name), texture(0) {
 
         setupMesh();
@@ -63,51 +51,25 @@ public:
         cleanup();
     }
 
-    virtual std::vector<Position> getPossibleMoves(const std::vector<std::vector<ChessPiece*>>& board) const {
-        std::vector<Position> moves;
-
-        if (canMoveAsRook) {
-            addRookMoves(moves, board);
-        }
-        if (canMoveAsBishop) {
-            addBishopMoves(moves, board);
-        }
-        if (canMoveAsKnight) {
-            addKnightMoves(moves, board);
-        }
-        if (canMoveAsPawn) {
-            addPawnMoves(moves, board);
-        }
-        if (canMoveAsKing) {
-            addKingMoves(moves, board);
-        }
-
-        return moves;
+    void getPossibleMoves(const BoardState& board, MoveList& moves) const {
+        addMoves(board, makeSquare(position), getTargets(board), moves);
     }
 
-    virtual bool canMoveTo(const Position& target, const std::vector<std::vector<ChessPiece*>>& board) const {
-        auto possibleMoves = getPossibleMoves(board);
-        return std::find(possibleMoves.begin(), possibleMoves.end(), target) != possibleMoves.end();
+    bool canMoveTo(const Position& target, const BoardState& board) const {
+        return (getTargets(board) & squareBB(makeSquare(target))) != 0;
     }
 
-    virtual bool moveTo(const Position& target, std::vector<std::vector<ChessPiece*>>& board) {
-        if (canMoveTo(target, board)) {
-            //     
-            board[position.y][position.x] = nullptr;
-
-            //    ( )
-            if (board[target.y][target.x] != nullptr) {
-                delete board[target.y][target.x];
-            }
+    Bitboard getTargets(const BoardState& board) const {
+        int sq = makeSquare(position);
+        bool firstMove = (board.unmoved & squareBB(sq)) != 0;
+        return PieceTargetTable[capabilities](board, sq, colorIndex(color), firstMove);
+    }
 
-            //     
-            board[target.y][target.x] = this;
-            position = target;
-            hasMoved = true;
-            convertToRenderCoords();
-            return true;
-        }
-        return false;
+    //    ,     
+    virtual void moveTo(const Position& target, bool moved = true) {
+        position = target;
+        hasMoved = moved;
+        convertToRenderCoords();
     }
 
     // 
@@ -128,20 +90,33 @@ public:
     }
 
     void loadTexture(const std::string& texturePath) {
+        if (texture != 0) {
+            glDeleteTextures(1, &texture);
+        }
         texture = loadTextureFromFile(texturePath.c_str());
     }
 
+    //   (  )
+    void setCapabilities(uint8_t caps, const std::string& name) {
+        capabilities = caps;
+        pieceName = name;
+    }
+
     // 
     PieceColor getColor() const { return color; }
     Position getPosition() const { return position; }
     std::string getName() const { return pieceName; }
     bool getHasMoved() const { return hasMoved; }
 
-    bool hasRookMovement() const { return canMoveAsRook; }
-    bool hasBishopMovement() const { return canMoveAsBishop; }
-    bool hasKnightMovement() const { return canMoveAsKnight; }
-    bool hasPawnMovement() const { return canMoveAsPawn; }
-    bool hasKingMovement() const { return canMoveAsKing; }
+    bool hasRookMovement() const { return (capabilities & CAP_ROOK) != 0; }
+    bool hasBishopMovement() const { return (capabilities & CAP_BISHOP) != 0; }
+    bool hasKnightMovement() const { return (capabilities & CAP_KNIGHT) != 0; }
+    bool hasPawnMovement() const { return (capabilities & CAP_PAWN) != 0; }
+    bool hasKingMovement() const { return (capabilities & CAP_KING) != 0; }
+
+    uint8_t getCapabilities() const { return capabilities; }
+
+    PieceCode getCode() const { return makePieceCode(color, getCapabilities()); }
 
     // 
     void setRenderPosition(float x, float y) {
@@ -263,192 +238,188 @@ private:
             glDeleteTextures(1, &texture);
         }
     }
+};
 
-    bool isValidPosition(const Position& pos) const {
-        return pos.x >= 0 && pos.x < 8 && pos.y >= 0 && pos.y < 8;
-    }
-
-    void addRookMoves(std::vector<Position>& moves, const std::vector<std::vector<ChessPiece*>>& board) const {
-        int directions[4][2] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };
-
-        for (int i = 0; i < 4; i++) {
-            int dx = directions[i][0];
-            int dy = directions[i][1];
+class ChessBoard {
+private:
+    //        
+    BoardState state;
+    ChessPiece* pieces[SQUARE_NB];
 
-            for (int step = 1; step < 8; step++) {
-                Position newPos(position.x + dx * step, position.y + dy * step);
+    //        (    )
+    std::vector<UndoRecord> undoStack;
+    std::vector<ChessPiece*> capturedPieces;
 
-                if (!isValidPosition(newPos)) break;
+public:
+    ChessBoard() {
+        ensureAttacksInitialized();
+        ensureZobristInitialized();
+        ensurePsqtInitialized();
+        std::fill(pieces, pieces + SQUARE_NB, nullptr);
+    }
 
-                ChessPiece* targetPiece = board[newPos.y][newPos.x];
-                if (targetPiece == nullptr) {
-                    moves.push_back(newPos);
-                }
-                else {
-                    if (targetPiece->getColor() != color) {
-                        moves.push_back(newPos); 
-                    }
-                    break; 
-                }
+    ~ChessBoard() {
+        for (int sq = 0; sq < SQUARE_NB; sq++) {
+            if (pieces[sq] != nullptr) {
+                delete pieces[sq];
             }
         }
+        for (ChessPiece* piece : capturedPieces) {
+            delete piece;
+        }
     }
 
-    void addBishopMoves(std::vector<Position>& moves, const std::vector<std::vector<ChessPiece*>>& board) const {
-        int directions[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
-
-        for (int i = 0; i < 4; i++) {
-            int dx = directions[i][0];
-            int dy = directions[i][1];
-
-            for (int step = 1; step < 8; step++) {
-                Position newPos(position.x + dx * step, position.y + dy * step);
-
-                if (!isValidPosition(newPos)) break;
-
-                ChessPiece* targetPiece = board[newPos.y][newPos.x];
-                if (targetPiece == nullptr) {
-                    moves.push_back(newPos);
-                }
-                else {
-                    if (targetPiece->getColor() != color) {
-                        moves.push_back(newPos);
-                    }
-                    break;
+    void placePiece(ChessPiece* piece, Position pos) {
+        if (isValidPosition(pos)) {
+            int sq = makeSquare(pos);
+            if (pieces[sq] != nullptr) {
+                delete pieces[sq];
+            }
+            state.removePiece(sq);
+            state.unmoved &= ~squareBB(sq);
+            pieces[sq] = piece;
+            if (piece != nullptr) {
+                state.putPiece(piece->getCode(), sq);
+                if (!piece->getHasMoved()) {
+                    state.unmoved |= squareBB(sq);
                 }
             }
+            state.setCastlingFromSetup();
         }
     }
 
-    void addKnightMoves(std::vector<Position>& moves, const std::vector<std::vector<ChessPiece*>>& board) const {
-        int knightMoves[8][2] = {
-            {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
-            {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
-        };
-
-        for (int i = 0; i < 8; i++) {
-            Position newPos(position.x + knightMoves[i][0], position.y + knightMoves[i][1]);
-
-            if (isValidPosition(newPos)) {
-                ChessPiece* targetPiece = board[newPos.y][newPos.x];
-                if (targetPiece == nullptr || targetPiece->getColor() != color) {
-                    moves.push_back(newPos);
-                }
-            }
+    ChessPiece* getPiece(Position pos) const {
+        if (isValidPosition(pos)) {
+            return pieces[makeSquare(pos)];
         }
+        return nullptr;
     }
 
-    void addPawnMoves(std::vector<Position>& moves, const std::vector<std::vector<ChessPiece*>>& board) const {
-        int direction = (color == PieceColor::WHITE) ? 1 : -1;
+    ChessPiece* getPiece(int sq) const {
+        return pieces[sq];
+    }
 
-        // 
-        Position frontPos(position.x, position.y + direction);
-        if (isValidPosition(frontPos) && board[frontPos.y][frontPos.x] == nullptr) {
-            moves.push_back(frontPos);
+    void getLegalMoves(MoveList& moves) const {
+        generateLegalMoves(state, moves);
+    }
 
-            //    
-            if (!hasMoved) {
-                Position doubleFrontPos(position.x, position.y + 2 * direction);
-                if (isValidPosition(doubleFrontPos) && board[doubleFrontPos.y][doubleFrontPos.x] == nullptr) {
-                    moves.push_back(doubleFrontPos);
-                }
-            }
+    //     ,    
+    Move findLegalMove(Position from, Position to) const {
+        if (!isValidPosition(from) || !isValidPosition(to)) {
+            return NO_MOVE;
         }
+        MoveList moves;
+        generateLegalMoves(state, moves);
+        return moves.find(makeSquare(from), makeSquare(to));
+    }
 
-        //  
-        for (int dx = -1; dx <= 1; dx += 2) {
-            Position capturePos(position.x + dx, position.y + direction);
-            if (isValidPosition(capturePos)) {
-                ChessPiece* targetPiece = board[capturePos.y][capturePos.x];
-                if (targetPiece != nullptr && targetPiece->getColor() != color) {
-                    moves.push_back(capturePos);
-                }
-            }
+    bool movePiece(Position from, Position to) {
+        Move m = findLegalMove(from, to);
+        if (m != NO_MOVE) {
+            make(m);
+            return true;
         }
+        return false;
     }
 
-    void addKingMoves(std::vector<Position>& moves, const std::vector<std::vector<ChessPiece*>>& board) const {
-        for (int dx = -1; dx <= 1; dx++) {
-            for (int dy = -1; dy <= 1; dy++) {
-                if (dx == 0 && dy == 0) continue;
+    void make(Move m) {
+        int from = fromSquare(m);
+        int to = toSquare(m);
+        int flags = moveFlags(m);
 
-                Position newPos(position.x + dx, position.y + dy);
-                if (isValidPosition(newPos)) {
-                    ChessPiece* targetPiece = board[newPos.y][newPos.x];
-                    if (targetPiece == nullptr || targetPiece->getColor() != color) {
-                        moves.push_back(newPos);
-                    }
-                }
-            }
-        }
-    }
-};
+        undoStack.emplace_back();
+        state.make(m, undoStack.back());
 
-class ChessBoard {
-private:
-    std::vector<std::vector<ChessPiece*>> board;
+        int capSq = flags == FLAG_EP_CAPTURE ? (from < to ? to - 8 : to + 8) : to;
+        capturedPieces.push_back(isCapture(m) ? pieces[capSq] : nullptr);
+        pieces[capSq] = nullptr;
 
-public:
-    ChessBoard() {
-        board.resize(8, std::vector<ChessPiece*>(8, nullptr));
-    }
+        relocate(from, to, true);
+        if (flags == FLAG_KING_CASTLE) relocate(from + 3, from + 1, true);
+        if (flags == FLAG_QUEEN_CASTLE) relocate(from - 4, from - 1, true);
 
-    ~ChessBoard() {
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                if (board[y][x] != nullptr) {
-                    delete board[y][x];
-                }
-            }
+        if (isPromotion(m)) {
+            uint8_t caps = BoardState::promotionCaps(m);
+            pieces[to]->setCapabilities(caps, capabilityName(caps));
         }
     }
 
-    void placePiece(ChessPiece* piece, Position pos) {
-        if (isValidPosition(pos)) {
-            if (board[pos.y][pos.x] != nullptr) {
-                delete board[pos.y][pos.x];
-            }
-            board[pos.y][pos.x] = piece;
+    void unmake(Move m) {
+        int from = fromSquare(m);
+        int to = toSquare(m);
+        int flags = moveFlags(m);
+
+        const UndoRecord& undo = undoStack.back();
+        if (isPromotion(m)) {
+            pieces[to]->setCapabilities(pieceCaps(undo.moved), capabilityName(pieceCaps(undo.moved)));
         }
+        relocate(to, from, (undo.unmoved & squareBB(from)) == 0);
+        if (flags == FLAG_KING_CASTLE) relocate(from + 1, from + 3, false);
+        if (flags == FLAG_QUEEN_CASTLE) relocate(from - 1, from - 4, false);
+
+        ChessPiece* captured = capturedPieces.back();
+        capturedPieces.pop_back();
+        if (captured != nullptr) {
+            int capSq = flags == FLAG_EP_CAPTURE ? (from < to ? to - 8 : to + 8) : to;
+            pieces[capSq] = captured;
+        }
+
+        state.unmake(m, undo);
+        undoStack.pop_back();
     }
 
-    ChessPiece* getPiece(Position pos) {
-        if (isValidPosition(pos)) {
-            return board[pos.y][pos.x];
-        }
-        return nullptr;
+    bool canUndo() const {
+        return !undoStack.empty();
     }
 
-    bool movePiece(Position from, Position to) {
-        if (isValidPosition(from) && isValidPosition(to)) {
-            ChessPiece* piece = board[from.y][from.x];
-            if (piece != nullptr) {
-                return piece->moveTo(to, board);
-            }
+    //       -   
+    std::vector<uint64_t> keyHistory() const {
+        std::vector<uint64_t> keys;
+        keys.reserve(undoStack.size());
+        for (const UndoRecord& undo : undoStack) {
+            keys.push_back(undo.key);
         }
-        return false;
+        return keys;
     }
 
 
     void renderAllPieces(Shader& shader) {
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                if (board[y][x] != nullptr) {
-                    board[y][x]->render(shader);
-                }
-            }
+        Bitboard occupied = state.occupied();
+        while (occupied) {
+            pieces[popLsb(occupied)]->render(shader);
         }
     }
 
-    std::vector<std::vector<ChessPiece*>>& getBoard() {
-        return board;
+    const BoardState& getState() const {
+        return state;
     }
 
 
 private:
-    bool isValidPosition(const Position& pos) {
+    bool isValidPosition(const Position& pos) const {
         return pos.x >= 0 && pos.x < 8 && pos.y >= 0 && pos.y < 8;
     }
+
+    static std::string capabilityName(uint8_t caps) {
+        switch (caps) {
+        case CAP_ROOK: return "Rook";
+        case CAP_BISHOP: return "Bishop";
+        case CAP_KNIGHT: return "Knight";
+        case CAP_PAWN: return "Pawn";
+        case CAP_KING: return "King";
+        case CAP_ROOK | CAP_BISHOP: return "Queen";
+        default: return "Custom Piece";
+        }
+    }
+
+    void relocate(int from, int to, bool moved) {
+        ChessPiece* piece = pieces[from];
+        pieces[from] = nullptr;
+        pieces[to] = piece;
+        if (piece != nullptr) {
+            piece->moveTo(squareToPosition(to), moved);
+        }
+    }
 };
 
 
@@ -0,0 +1,203 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "board_state.h"
+#include "psqt.h"
+#include "zobrist.h"
+#include "kpk.h"
+
+//      .   
+//   ,       
+// :     ,  
+//    .
+
+//  ,   :     
+const int VALUE_KNOWN_WIN = 10000;
+
+//   , 64 -  
+const int SCALE_NORMAL = 64;
+
+//    
+typedef int (*EndgameEval)(const BoardState& board, int strong);
+// 0..SCALE_NORMAL
+typedef int (*EndgameScale)(const BoardState& board, int strong);
+
+struct EndgameEntry {
+    uint64_t key = 0;
+    EndgameEval eval = nullptr;
+    EndgameScale scale = nullptr;
+    uint8_t strong = 0;
+};
+
+inline int squareDistance(int a, int b) {
+    return std::max(std::abs(a % 8 - b % 8), std::abs(a / 8 - b / 8));
+}
+
+// 0  , 6  
+inline int centerDistance(int sq) {
+    int f = sq % 8;
+    int r = sq / 8;
+    return std::max(3 - f, f - 4) + std::max(3 - r, r - 4);
+}
+
+inline int egMaterial(const BoardState& board, int color) {
+    int total = 0;
+    for (Bitboard b = board.byColor[color]; b; ) {
+        total += EvalParams.eg[pieceCaps(board.pieceOn(popLsb(b)))];
+    }
+    return total;
+}
+
+//  :      
+inline int evalMateLoneKing(const BoardState& board, int strong) {
+    int sk = board.kingSquare(strong);
+    int wk = board.kingSquare(strong ^ 1);
+    return VALUE_KNOWN_WIN + egMaterial(board, strong)
+        + 20 * centerDistance(wk) + 10 * (7 - squareDistance(sk, wk));
+}
+
+//   :      
+inline int evalKBNK(const BoardState& board, int strong) {
+    int sk = board.kingSquare(strong);
+    int wk = board.kingSquare(strong ^ 1);
+    int bishop = lsb(board.piecesWith(strong ? PieceColor::BLACK : PieceColor::WHITE, CAP_BISHOP));
+    bool dark = (bishop % 8 + bishop / 8) % 2 == 0;
+    int corner = dark ? std::min(squareDistance(wk, 0), squareDistance(wk, 63))
+        : std::min(squareDistance(wk, 7), squareDistance(wk, 56));
+    return VALUE_KNOWN_WIN + egMaterial(board, strong)
+        + 40 * (7 - corner) + 10 * (7 - squareDistance(sk, wk));
+}
+
+inline int evalKPK(const BoardState& board, int strong) {
+    int sk = board.kingSquare(strong);
+    int wk = board.kingSquare(strong ^ 1);
+    int pawn = lsb(board.plainPawns(strong));
+    if (!kpkProbe(strong, sk, pawn, wk, board.sideToMove)) {
+        return 0;
+    }
+    int relRank = strong == 0 ? pawn / 8 : 7 - pawn / 8;
+    return VALUE_KNOWN_WIN + egMaterial(board, strong) + 20 * relRank;
+}
+
+inline int evalDraw(const BoardState&, int) {
+    return 0;
+}
+
+//       
+inline int scaleRookVsMinor(const BoardState&, int) {
+    return 16;
+}
+
+//       :     
+inline int scaleKBPK(const BoardState& board, int strong) {
+    int pawn = lsb(board.plainPawns(strong));
+    if (pawn % 8 != 0 && pawn % 8 != 7) {
+        return SCALE_NORMAL;
+    }
+    int promo = strong == 0 ? pawn % 8 + 56 : pawn % 8;
+    int bishop = lsb(board.piecesWith(strong ? PieceColor::BLACK : PieceColor::WHITE, CAP_BISHOP));
+    bool sameColor = (bishop % 8 + bishop / 8) % 2 == (promo % 8 + promo / 8) % 2;
+    if (!sameColor && squareDistance(board.kingSquare(strong ^ 1), promo) <= 1) {
+        return 0;
+    }
+    return SCALE_NORMAL;
+}
+
+//      .   
+//  ,       
+//   :  -    .
+class EndgameTable {
+public:
+    void add(const std::string& strong, const std::string& weak, EndgameEval eval, EndgameScale scale) {
+        //        
+        for (int color = 0; color < (strong == weak ? 1 : 2); color++) {
+            EndgameEntry e;
+            e.key = signatureKey(color == 0 ? strong : weak, color == 0 ? weak : strong);
+            e.eval = eval;
+            e.scale = scale;
+            e.strong = uint8_t(color);
+            pending.push_back(e);
+        }
+    }
+
+    void build() {
+        size_t size = 64;
+        while (!tryBuild(size)) {
+            size *= 2;
+        }
+        pending.clear();
+    }
+
+    const EndgameEntry* probe(uint64_t materialKey) const {
+        const EndgameEntry& e = entries[materialKey & mask];
+        return e.key == materialKey && (e.eval || e.scale) ? &e : nullptr;
+    }
+
+private:
+    std::vector<EndgameEntry> entries{ 1 };
+    std::vector<EndgameEntry> pending;
+    uint64_t mask = 0;
+
+    //     "KRP"    "KB"  
+    static uint64_t signatureKey(const std::string& white, const std::string& black) {
+        uint8_t count[PIECE_CODE_NB] = {};
+        uint64_t key = 0;
+        for (int color = 0; color < 2; color++) {
+            for (char c : color == 0 ? white : black) {
+                uint8_t caps = c == 'K' ? CAP_KING : c == 'Q' ? CAP_ROOK | CAP_BISHOP
+                    : c == 'R' ? CAP_ROOK : c == 'B' ? CAP_BISHOP : c == 'N' ? CAP_KNIGHT : CAP_PAWN;
+                PieceCode code = makePieceCode(color ? PieceColor::BLACK : PieceColor::WHITE, caps);
+                key ^= Zobrist.material[code][count[code]++];
+            }
+        }
+        return key;
+    }
+
+    bool tryBuild(size_t size) {
+        std::vector<EndgameEntry> table(size);
+        for (const EndgameEntry& e : pending) {
+            EndgameEntry& slot = table[e.key & (size - 1)];
+            if (slot.eval || slot.scale) {
+                return false;
+            }
+            slot = e;
+        }
+        entries.swap(table);
+        mask = size - 1;
+        return true;
+    }
+};
+
+inline EndgameTable Endgames;
+
+inline bool initEndgames() {
+    ensureZobristInitialized();
+    ensurePsqtInitialized();
+    Endgames.add("KQ", "K", evalMateLoneKing, nullptr);
+    Endgames.add("KR", "K", evalMateLoneKing, nullptr);
+    Endgames.add("KBN", "K", evalKBNK, nullptr);
+    Endgames.add("KP", "K", evalKPK, nullptr);
+    Endgames.add("K", "K", evalDraw, nullptr);
+    Endgames.add("KB", "K", evalDraw, nullptr);
+    Endgames.add("KN", "K", evalDraw, nullptr);
+    Endgames.add("KNN", "K", evalDraw, nullptr);
+    Endgames.add("KR", "KB", nullptr, scaleRookVsMinor);
+    Endgames.add("KR", "KN", nullptr, scaleRookVsMinor);
+    Endgames.add("KBP", "K", nullptr, scaleKBPK);
+    Endgames.build();
+    return true;
+}
+
+inline void ensureEndgamesInitialized() {
+    static const bool initialized = initEndgames();
+    (void)initialized;
+}
+
+#endif // ENDGAME_H
@@ -0,0 +1,80 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "board_state.h"
+#include "endgame.h"
+#include "pawns.h"
+#include "psqt.h"
+
+//   
+const int Tempo = 10;
+
+//  :       .
+//    BoardState   , 
+//       .  
+//       .
+inline int evaluate(const BoardState& board, PawnTable& pawns) {
+    const EndgameEntry* eg = Endgames.probe(board.materialKey);
+    if (eg && eg->eval) {
+        int v = eg->eval(board, eg->strong);
+        return board.sideToMove == eg->strong ? v : -v;
+    }
+
+    PawnEntry& e = pawns.probe(board);
+    PackedScore score = board.psqt + e.score
+        + makeScore(pawns.shelter(board, e, 0) - pawns.shelter(board, e, 1), 0);
+
+    int scale = eg ? eg->scale(board, eg->strong) : SCALE_NORMAL;
+    int phase = std::min(int(board.phase), PHASE_MAX);
+    int v = (mgValue(score) * phase + egValue(score) * scale / SCALE_NORMAL * (PHASE_MAX - phase)) / PHASE_MAX;
+    return (board.sideToMove == 0 ? v : -v) + Tempo;
+}
+
+//      ,    : ,
+//   ,   .
+class EvalCache {
+public:
+    static const int SIZE = 16384;
+
+    CacheStats stats;
+
+    EvalCache() : entries(new Entry[SIZE]) {
+        clear();
+    }
+
+    void clear() {
+        for (int i = 0; i < SIZE; i++) {
+            entries[i] = Entry();
+        }
+    }
+
+    bool probe(uint64_t key, int& value) {
+        const Entry& e = entries[key & (SIZE - 1)];
+        bool hit = e.key == key && e.valid;
+        stats.record(hit);
+        if (hit) value = e.value;
+        return hit;
+    }
+
+    void store(uint64_t key, int value) {
+        Entry& e = entries[key & (SIZE - 1)];
+        e.key = key;
+        e.value = int16_t(value);
+        e.valid = true;
+    }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        int16_t value = 0;
+        bool valid = false;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+};
+
+#endif // EVAL_H
@@ -0,0 +1,190 @@
+#ifndef FEN_H
+#define FEN_H
+
+#include <string>
+#include <sstream>
+#include <cctype>
+
+#include "board_state.h"
+#include "movegen.h"
+
+// FEN     UCI.     PNBRQK,
+//  -    : [RN] -  -,
+// [pn] -  -.
+
+inline std::string squareToString(int sq) {
+    return std::string{ char('a' + (sq & 7)), char('1' + (sq >> 3)) };
+}
+
+const char* const StartFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+inline uint8_t capsFromLetter(char c) {
+    switch (std::tolower((unsigned char)c)) {
+    case 'r': return CAP_ROOK;
+    case 'b': return CAP_BISHOP;
+    case 'n': return CAP_KNIGHT;
+    case 'p': return CAP_PAWN;
+    case 'k': return CAP_KING;
+    case 'q': return CAP_ROOK | CAP_BISHOP;
+    default: return 0;
+    }
+}
+
+inline std::string pieceToString(PieceCode code) {
+    static const char letters[CAP_COUNT] = { 'R', 'B', 'N', 'P', 'K' };
+    uint8_t caps = pieceCaps(code);
+    std::string s;
+
+    if (caps == (CAP_ROOK | CAP_BISHOP)) {
+        s = "Q";
+    }
+    else if (popCount(caps) == 1) {
+        s = letters[lsb(caps)];
+    }
+    else {
+        s = "[";
+        for (int i = 0; i < CAP_COUNT; i++) {
+            if (caps & (1 << i)) s += letters[i];
+        }
+        s += "]";
+    }
+
+    if (pieceColor(code) == PieceColor::BLACK) {
+        for (char& c : s) c = (char)std::tolower((unsigned char)c);
+    }
+    return s;
+}
+
+inline bool setFen(BoardState& board, const std::string& fen) {
+    ensurePsqtInitialized();
+    std::istringstream ss(fen);
+    std::string placement, side, castling, ep;
+    int rule50 = 0, fullmove = 1;
+
+    if (!(ss >> placement >> side)) return false;
+    if (!(ss >> castling)) castling = "-";
+    if (!(ss >> ep)) ep = "-";
+    ss >> rule50 >> fullmove;
+
+    board.clear();
+
+    int x = 0, y = 7;
+    for (size_t i = 0; i < placement.size(); i++) {
+        char c = placement[i];
+        if (c == '/') {
+            y--;
+            x = 0;
+        }
+        else if (std::isdigit((unsigned char)c)) {
+            x += c - '0';
+        }
+        else {
+            uint8_t caps = 0;
+            bool white;
+            if (c == '[') {
+                size_t close = placement.find(']', i);
+                if (close == std::string::npos || close == i + 1) return false;
+                white = std::isupper((unsigned char)placement[i + 1]) != 0;
+                for (size_t j = i + 1; j < close; j++) {
+                    caps |= capsFromLetter(placement[j]);
+                }
+                i = close;
+            }
+            else {
+                white = std::isupper((unsigned char)c) != 0;
+                caps = capsFromLetter(c);
+            }
+            if (caps == 0 || x > 7 || y < 0) return false;
+            board.putPiece(makePieceCode(white ? PieceColor::WHITE : PieceColor::BLACK, caps), makeSquare(x, y));
+            x++;
+        }
+    }
+
+    board.sideToMove = side == "b" ? 1 : 0;
+
+    //        -    
+    board.unmoved = (board.piecesWith(PieceColor::WHITE, CAP_PAWN) & (RANK_1_BB << 8))
+        | (board.piecesWith(PieceColor::BLACK, CAP_PAWN) & (RANK_1_BB << 48));
+
+    for (char c : castling) {
+        if (c != 'K' && c != 'Q' && c != 'k' && c != 'q') continue;
+
+        int us = std::isupper((unsigned char)c) ? 0 : 1;
+        int base = us == 0 ? 0 : 56;
+        int rookSq = std::tolower((unsigned char)c) == 'k' ? base + 7 : base;
+        if (board.kingSquare(us) != base + 4
+            || !(board.piecesWith(PieceColor(us), CAP_ROOK) & squareBB(rookSq))) {
+            continue;
+        }
+        board.castling |= rookSq == base + 7 ? (us == 0 ? WHITE_OO : BLACK_OO) : (us == 0 ? WHITE_OOO : BLACK_OOO);
+        board.unmoved |= squareBB(base + 4) | squareBB(rookSq);
+    }
+
+    if (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && (ep[1] == '3' || ep[1] == '6')) {
+        int epSq = makeSquare(ep[0] - 'a', ep[1] - '1');
+        int us = board.sideToMove;
+        if (PawnAttacks[us ^ 1][epSq] & board.piecesWith(PieceColor(us), CAP_PAWN)) {
+            board.epSquare = uint8_t(epSq);
+        }
+    }
+
+    board.rule50 = uint8_t(rule50);
+    board.gamePly = uint16_t(2 * (fullmove > 0 ? fullmove - 1 : 0) + board.sideToMove);
+    board.refreshKeys();
+    board.refreshEval();
+    return true;
+}
+
+inline std::string getFen(const BoardState& board) {
+    std::ostringstream ss;
+
+    for (int y = 7; y >= 0; y--) {
+        int empty = 0;
+        for (int x = 0; x < 8; x++) {
+            PieceCode code = board.pieceOn(makeSquare(x, y));
+            if (code == NO_PIECE) {
+                empty++;
+                continue;
+            }
+            if (empty) ss << empty;
+            empty = 0;
+            ss << pieceToString(code);
+        }
+        if (empty) ss << empty;
+        if (y > 0) ss << '/';
+    }
+
+    ss << (board.sideToMove ? " b " : " w ");
+
+    if (board.castling == 0) ss << '-';
+    if (board.castling & WHITE_OO) ss << 'K';
+    if (board.castling & WHITE_OOO) ss << 'Q';
+    if (board.castling & BLACK_OO) ss << 'k';
+    if (board.castling & BLACK_OOO) ss << 'q';
+
+    ss << ' ' << (board.epSquare == NO_SQUARE ? "-" : squareToString(board.epSquare));
+    ss << ' ' << int(board.rule50) << ' ' << 1 + board.gamePly / 2;
+    return ss.str();
+}
+
+inline std::string moveToString(Move m) {
+    if (m == NO_MOVE) return "0000";
+
+    std::string s = squareToString(fromSquare(m)) + squareToString(toSquare(m));
+    if (isPromotion(m)) {
+        s += "nbrq"[moveFlags(m) & 3];
+    }
+    return s;
+}
+
+//    , NO_MOVE   
+inline Move parseMove(const BoardState& board, const std::string& str) {
+    MoveList moves;
+    generateLegalMoves(board, moves);
+    for (Move m : moves) {
+        if (moveToString(m) == str) return m;
+    }
+    return NO_MOVE;
+}
+
+#endif // FEN_H
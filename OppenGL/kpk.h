@@ -0,0 +1,40 @@
+#ifndef KPK_H
+#define KPK_H
+
+#include <cstdint>
+
+#include "bitboard.h"
+
+//   +  :     
+// .        a-d;  -
+//  ,     (4  x 6 ),
+//  2 x 24 x 64 x 64  = 24 .    kpkgen.
+
+const int KPK_SIZE = 2 * 24 * SQUARE_NB * SQUARE_NB;
+
+// stm: 0 -    
+inline int kpkIndex(int stm, int strongKing, int weakKing, int pawn) {
+    return strongKing | (weakKing << 6) | (stm << 12) | ((pawn % 8) << 13) | ((6 - pawn / 8) << 15);
+}
+
+#ifndef KPK_GENERATOR
+#include "kpk_bitbase.h"
+
+// strong -    , stm - ,  
+inline bool kpkProbe(int strong, int strongKing, int pawn, int weakKing, int stm) {
+    if (strong == 1) {
+        strongKing ^= 56;
+        weakKing ^= 56;
+        pawn ^= 56;
+    }
+    if (pawn % 8 >= 4) {
+        strongKing ^= 7;
+        weakKing ^= 7;
+        pawn ^= 7;
+    }
+    int idx = kpkIndex(stm != strong, strongKing, weakKing, pawn);
+    return (KpkBitbase[idx >> 6] >> (idx & 63)) & 1;
+}
+#endif
+
+#endif // KPK_H
@@ -0,0 +1,158 @@
+//    KPK      
+// kpk_bitbase.h.  ,    ,
+//     ,   .
+//
+// kpkgen []      -   
+
+#define KPK_GENERATOR
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "attacks.h"
+#include "kpk.h"
+
+enum KpkResult : uint8_t {
+    KPK_INVALID = 0,
+    KPK_UNKNOWN = 1,
+    KPK_DRAW = 2,
+    KPK_WIN = 4
+};
+
+int distance(int a, int b) {
+    return std::max(std::abs(a % 8 - b % 8), std::abs(a / 8 - b / 8));
+}
+
+//   :  ,  ,
+//     
+KpkResult classifyInitial(int stm, int wk, int bk, int psq) {
+    if (wk == bk || wk == psq || bk == psq || distance(wk, bk) <= 1) {
+        return KPK_INVALID;
+    }
+    if (stm == 0 && (PawnAttacks[0][psq] & squareBB(bk))) {
+        return KPK_INVALID;
+    }
+    if (stm == 0 && psq / 8 == 6) {
+        int promo = psq + 8;
+        if (wk != promo && bk != promo && (distance(bk, promo) > 1 || distance(wk, promo) == 1)) {
+            return KPK_WIN;
+        }
+    }
+    if (stm == 1) {
+        Bitboard escapes = KingAttacks[bk] & ~(KingAttacks[wk] | PawnAttacks[0][psq]);
+        if (!escapes) {
+            return KPK_DRAW;
+        }
+        if ((KingAttacks[bk] & squareBB(psq)) && !(KingAttacks[wk] & squareBB(psq))) {
+            return KPK_DRAW;
+        }
+    }
+    return KPK_UNKNOWN;
+}
+
+KpkResult classify(const std::vector<uint8_t>& db, int stm, int wk, int bk, int psq) {
+    int r = KPK_INVALID;
+    if (stm == 0) {
+        for (Bitboard b = KingAttacks[wk]; b; ) {
+            r |= db[kpkIndex(1, popLsb(b), bk, psq)];
+        }
+        if (psq / 8 < 6 && psq + 8 != wk && psq + 8 != bk) {
+            r |= db[kpkIndex(1, wk, bk, psq + 8)];
+            if (psq / 8 == 1 && psq + 16 != wk && psq + 16 != bk) {
+                r |= db[kpkIndex(1, wk, bk, psq + 16)];
+            }
+        }
+        return (r & KPK_WIN) ? KPK_WIN : (r & KPK_UNKNOWN) ? KPK_UNKNOWN : KPK_DRAW;
+    }
+
+    for (Bitboard b = KingAttacks[bk]; b; ) {
+        r |= db[kpkIndex(0, wk, popLsb(b), psq)];
+    }
+    return (r & KPK_DRAW) ? KPK_DRAW : (r & KPK_UNKNOWN) ? KPK_UNKNOWN : KPK_WIN;
+}
+
+std::vector<uint64_t> generate() {
+    std::vector<uint8_t> db(KPK_SIZE, KPK_INVALID);
+    for (int stm = 0; stm < 2; stm++) {
+        for (int wk = 0; wk < SQUARE_NB; wk++) {
+            for (int bk = 0; bk < SQUARE_NB; bk++) {
+                for (int rank = 1; rank <= 6; rank++) {
+                    for (int file = 0; file < 4; file++) {
+                        int psq = makeSquare(file, rank);
+                        db[kpkIndex(stm, wk, bk, psq)] = classifyInitial(stm, wk, bk, psq);
+                    }
+                }
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int idx = 0; idx < KPK_SIZE; idx++) {
+            if (db[idx] != KPK_UNKNOWN) continue;
+            int wk = idx & 63;
+            int bk = (idx >> 6) & 63;
+            int stm = (idx >> 12) & 1;
+            int psq = makeSquare((idx >> 13) & 3, 6 - (idx >> 15));
+            KpkResult r = classify(db, stm, wk, bk, psq);
+            if (r != KPK_UNKNOWN) {
+                db[idx] = r;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<uint64_t> bits(KPK_SIZE / 64, 0);
+    for (int idx = 0; idx < KPK_SIZE; idx++) {
+        if (db[idx] == KPK_WIN) {
+            bits[idx >> 6] |= 1ULL << (idx & 63);
+        }
+    }
+    return bits;
+}
+
+int main(int argc, char* argv[]) {
+    ensureAttacksInitialized();
+    std::vector<uint64_t> bits = generate();
+
+    std::ostringstream out;
+    out << "#ifndef KPK_BITBASE_H\n#define KPK_BITBASE_H\n\n"
+        << "#include <cstdint>\n\n"
+        << "//  kpkgen,   .\n"
+        << "constexpr uint64_t KpkBitbase[" << bits.size() << "] = {\n";
+    for (size_t i = 0; i < bits.size(); i++) {
+        if (i % 4 == 0) out << "    ";
+        out << "0x";
+        out.width(16);
+        out.fill('0');
+        out << std::hex << bits[i] << std::dec << "ULL";
+        if (i + 1 < bits.size()) out << (i % 4 == 3 ? ",\n" : ", ");
+    }
+    out << "\n};\n\n#endif // KPK_BITBASE_H\n";
+
+    if (argc < 2) {
+        std::cout << out.str();
+        return 0;
+    }
+
+    std::ifstream old(argv[1], std::ios::binary);
+    std::stringstream current;
+    current << old.rdbuf();
+    if (old && current.str() == out.str()) {
+        return 0;
+    }
+    std::ofstream file(argv[1], std::ios::binary);
+    file << out.str();
+    if (!file) {
+        std::cerr << "Cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
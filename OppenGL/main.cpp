@@ -1,13 +1,18 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 #include <random>
 #include <vector>
 #include <cmath>
+#include <string>
 
 #include "shader.h"
 #include "stb_image.h"
 #include "chess_piece.h"
+#include "fen.h"
+#include "search.h"
  
 const float quadLeft = -0.05f;
 const float quadRight = 0.05f;
@@ -27,6 +32,37 @@ float draggedPieceX = 0.0f;
 float draggedPieceY = 0.0f;
 
 PieceColor currentPlayer = PieceColor::WHITE;
+
+//    engineColor;     ,
+//        
+Search* globalSearch = nullptr;
+bool engineEnabled = false;
+bool engineThinking = false;
+PieceColor engineColor = PieceColor::BLACK;
+const int64_t engineMoveTime = 1000;
+//   ,       
+bool enginePondering = false;
+Move ponderMove = NO_MOVE;
+std::chrono::steady_clock::time_point ponderStart;
+// ,      
+Move expectedReply = NO_MOVE;
+
+//    ,       ,
+//    - . ,    
+// ,   ;     .
+struct SpeculativeLine {
+    Move move;
+    SearchInfo reply;
+    bool done;
+};
+std::vector<SpeculativeLine> speculation;
+int speculativeCurrent = -1;
+//     ,      
+const int64_t speculationDwell = 150;
+// ,     
+bool replyReady = false;
+SearchInfo readyReply;
+
 bool boardFlipped = false;
 float flipTransition = 0.0f;
 bool isFlipping = false;
@@ -103,6 +139,247 @@ void updateFlipAnimation(float deltaTime) {
 }
 
 
+std::string pieceTexturePath(PieceColor color, uint8_t caps) {
+    std::string name;
+    switch (caps) {
+    case CAP_ROOK: name = "rook"; break;
+    case CAP_BISHOP: name = "bishop"; break;
+    case CAP_KNIGHT: name = "knight"; break;
+    case CAP_KING: name = "king"; break;
+    case CAP_PAWN: name = "pawn"; break;
+    default: name = "queen"; break;
+    }
+    return std::string("texture/") + (color == PieceColor::WHITE ? "white_" : "") + name + ".png";
+}
+
+void reportGameState() {
+    MoveList moves;
+    globalChessBoard->getLegalMoves(moves);
+    if (moves.size() == 0) {
+        std::cout << (globalChessBoard->getState().inCheck() ? "!" : "!") << std::endl;
+    }
+    else if (globalChessBoard->getState().inCheck()) {
+        std::cout << "!" << std::endl;
+    }
+}
+
+//     :  -    
+//    ,  .  
+//    .
+void resolvePonder(Move move) {
+    for (const SpeculativeLine& line : speculation) {
+        if (line.move == move && line.done) {
+            readyReply = line.reply;
+            replyReady = true;
+        }
+    }
+    speculation.clear();
+    speculativeCurrent = -1;
+    expectedReply = NO_MOVE;
+
+    if (!enginePondering) return;
+
+    enginePondering = false;
+    if (move == ponderMove) {
+        globalSearch->ponderhit();
+        engineThinking = true;
+        std::cout << " ,   " << std::endl;
+    }
+    else {
+        globalSearch->stop();
+    }
+}
+
+//       
+void applyMove(Move move) {
+    resolvePonder(move);
+    globalChessBoard->make(move);
+
+    ChessPiece* piece = globalChessBoard->getPiece(toSquare(move));
+    if (isPromotion(move)) {
+        piece->loadTexture(pieceTexturePath(piece->getColor(), piece->getCapabilities()));
+    }
+    switchPlayer();
+    std::cout << " !  : " << (currentPlayer == PieceColor::WHITE ? "WHITE" : "BLACK") << std::endl;
+    reportGameState();
+}
+
+//      expected:    
+// ,    ponderhit
+bool startReplySearch(Move expected) {
+    BoardState state = globalChessBoard->getState();
+    MoveList moves;
+    generateLegalMoves(state, moves);
+    if (std::find(moves.begin(), moves.end(), expected) == moves.end()) return false;
+
+    std::vector<uint64_t> keys = globalChessBoard->keyHistory();
+    keys.push_back(state.key);
+    UndoRecord undo;
+    state.make(expected, undo);
+    MoveList replies;
+    generateLegalMoves(state, replies);
+    if (replies.size() == 0) return false;
+
+    SearchLimits limits;
+    limits.moveTime = engineMoveTime;
+    limits.ponder = true;
+    globalSearch->start(state, keys, limits);
+    enginePondering = true;
+    ponderMove = expected;
+    ponderStart = std::chrono::steady_clock::now();
+    return true;
+}
+
+//           -
+// ,     
+void startPondering(const SearchInfo& info) {
+    if (info.pv.size() >= 2 && startReplySearch(info.pv[1])) {
+        expectedReply = info.pv[1];
+    }
+}
+
+//    :   -   ;
+//       ,   
+void startSpeculation(int from) {
+    speculation.clear();
+    speculativeCurrent = -1;
+    if (globalSearch == nullptr || !engineEnabled || engineThinking || currentPlayer == engineColor) return;
+
+    MoveList moves;
+    globalChessBoard->getLegalMoves(moves);
+    for (Move m : moves) {
+        if (fromSquare(m) == from) {
+            speculation.push_back({ m, SearchInfo(), false });
+        }
+    }
+    if (!enginePondering) return;
+
+    for (int i = 0; i < (int)speculation.size(); i++) {
+        if (speculation[i].move == ponderMove) {
+            speculativeCurrent = i;
+            return;
+        }
+    }
+    globalSearch->stop();
+    enginePondering = false;
+}
+
+//    :     ,
+//     
+void stopSpeculation() {
+    if (speculation.empty()) return;
+
+    speculation.clear();
+    speculativeCurrent = -1;
+    if (enginePondering && ponderMove == expectedReply) return;
+
+    if (enginePondering) {
+        globalSearch->stop();
+        enginePondering = false;
+    }
+    if (expectedReply != NO_MOVE) {
+        startReplySearch(expectedReply);
+    }
+}
+
+//  ,       
+int nearestCandidate() {
+    int nearest = -1;
+    float best = std::numeric_limits<float>::max();
+    for (int i = 0; i < (int)speculation.size(); i++) {
+        if (speculation[i].done) continue;
+
+        float x, y;
+        boardToRenderCoords(squareToPosition(toSquare(speculation[i].move)), x, y);
+        float d = (x - draggedPieceX) * (x - draggedPieceX) + (y - draggedPieceY) * (y - draggedPieceY);
+        if (d < best) {
+            best = d;
+            nearest = i;
+        }
+    }
+    return nearest;
+}
+
+//   ,    :      
+//     -     
+void updateSpeculation() {
+    if (speculation.empty() || !isdrag) return;
+
+    int nearest = nearestCandidate();
+    if (speculativeCurrent >= 0) {
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - ponderStart).count();
+        bool finished = elapsed >= engineMoveTime || !globalSearch->isRunning();
+        if (!finished && (nearest == speculativeCurrent || elapsed < speculationDwell)) return;
+
+        globalSearch->stop();
+        enginePondering = false;
+        SpeculativeLine& line = speculation[speculativeCurrent];
+        line.reply = globalSearch->poll();
+        line.done = finished && line.reply.bestMove != NO_MOVE;
+        speculativeCurrent = -1;
+        nearest = nearestCandidate();
+    }
+    if (nearest < 0) return;
+
+    if (startReplySearch(speculation[nearest].move)) {
+        speculativeCurrent = nearest;
+    }
+    else {
+        //       -  
+        speculation[nearest].done = true;
+    }
+}
+
+//     
+void playEngineMove(const SearchInfo& info) {
+    if (info.bestMove == NO_MOVE || currentPlayer != engineColor) return;
+
+    std::cout << ": " << moveToString(info.bestMove) << " ( " << info.depth
+        << ",  " << info.score << ",  " << info.nodes << ", EBF " << info.ebf
+        << ",   " << int(info.pawnHitRate) << "%,  " << int(info.evalHitRate) << "%)" << std::endl;
+    std::cout << ":";
+    for (Move m : info.pv) {
+        std::cout << " " << moveToString(m);
+    }
+    std::cout << std::endl;
+    applyMove(info.bestMove);
+    startPondering(info);
+}
+
+//   :      ,   
+void updateEngine() {
+    if (globalSearch == nullptr || !engineEnabled) return;
+
+    if (engineThinking) {
+        if (globalSearch->isRunning()) return;
+
+        globalSearch->stop();
+        engineThinking = false;
+        playEngineMove(globalSearch->poll());
+    }
+    else if (currentPlayer != engineColor) {
+        updateSpeculation();
+    }
+    else if (!isdrag && !isFlipping) {
+        //  ,    
+        if (replyReady) {
+            replyReady = false;
+            playEngineMove(readyReply);
+            return;
+        }
+
+        MoveList moves;
+        globalChessBoard->getLegalMoves(moves);
+        if (moves.size() == 0) return;
+
+        SearchLimits limits;
+        limits.moveTime = engineMoveTime;
+        globalSearch->start(globalChessBoard->getState(), globalChessBoard->keyHistory(), limits);
+        engineThinking = true;
+    }
+}
+
 bool isPointInPiece(float x, float y, ChessPiece* piece) {
     if (piece == nullptr) return false;
 
@@ -117,13 +394,11 @@ bool isPointInPiece(float x, float y, ChessPiece* piece) {
 ChessPiece* findPieceUnderCursor(float x, float y) {
     if (globalChessBoard == nullptr) return nullptr;
 
-    auto& board = globalChessBoard->getBoard();
-    for (int boardY = 0; boardY < 8; boardY++) {
-        for (int boardX = 0; boardX < 8; boardX++) {
-            ChessPiece* piece = board[boardY][boardX];
-            if (piece != nullptr && isPointInPiece(x, y, piece)) {
-                return piece;
-            }
+    Bitboard occupied = globalChessBoard->getState().occupied();
+    while (occupied) {
+        ChessPiece* piece = globalChessBoard->getPiece(popLsb(occupied));
+        if (isPointInPiece(x, y, piece)) {
+            return piece;
         }
     }
     return nullptr;
@@ -196,6 +471,10 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
                 draggedPieceX = pieceRenderX; 
                 draggedPieceY = pieceRenderY;
 
+                if (clickedPiece->getColor() == currentPlayer) {
+                    startSpeculation(makeSquare(draggedPieceOriginalPos));
+                }
+
                 if (boardFlipped) {
                     dragOffsetX = x - pieceRenderX;
                     dragOffsetY = y - pieceRenderY;
@@ -212,28 +491,27 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 
                 Position targetPos = screenToBoardPosition(draggedPieceX, draggedPieceY);
 
-                if (draggedPiece->getColor() != currentPlayer) {
+                if (engineEnabled && currentPlayer == engineColor) {
+                    std::cout << "  !" << std::endl;
+                    boardToRenderCoords(draggedPieceOriginalPos, draggedPieceX, draggedPieceY);
+                }
+                else if (draggedPiece->getColor() != currentPlayer) {
                     std::cout << "  !  : "
                         << (currentPlayer == PieceColor::WHITE ? "WHITE" : "BLACK") << std::endl;
                     boardToRenderCoords(draggedPieceOriginalPos, draggedPieceX, draggedPieceY);
                 }
-                else if (draggedPiece->canMoveTo(targetPos, globalChessBoard->getBoard())) {
-
-                    if (globalChessBoard->movePiece(draggedPieceOriginalPos, targetPos)) {
-                        switchPlayer();
-                        std::cout << " !  : " << (currentPlayer == PieceColor::WHITE ? "WHITE" : "BLACK") << std::endl;
-                    }
-                    else {
-                        std::cout << "   !" << std::endl;
-                        boardToRenderCoords(draggedPieceOriginalPos, draggedPieceX, draggedPieceY);
-                    }
+                else if (Move move = globalChessBoard->findLegalMove(draggedPieceOriginalPos, targetPos)) {
+                    applyMove(move);
                 }
                 else {
                     std::cout << " !     ." << std::endl;
-                    auto possibleMoves = draggedPiece->getPossibleMoves(globalChessBoard->getBoard());
+                    MoveList possibleMoves;
+                    globalChessBoard->getLegalMoves(possibleMoves);
                     std::cout << " : ";
-                    for (const auto& move : possibleMoves) {
-                        std::cout << "(" << move.x << "," << move.y << ") ";
+                    for (Move move : possibleMoves) {
+                        if (fromSquare(move) != makeSquare(draggedPieceOriginalPos)) continue;
+                        Position to = squareToPosition(toSquare(move));
+                        std::cout << "(" << to.x << "," << to.y << ") ";
                     }
                     std::cout << std::endl;
 
@@ -242,6 +520,7 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
                 }
 
                 //   
+                stopSpeculation();
                 draggedPiece = nullptr;
                 draggedPieceOriginalPos = Position(-1, -1);
             }
@@ -259,6 +538,24 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, GL_TRUE);
     }
+    // E -   ,   ,  - 
+    if (key == GLFW_KEY_E && action == GLFW_PRESS && globalSearch != nullptr) {
+        engineEnabled = !engineEnabled;
+        if (engineEnabled) {
+            engineColor = currentPlayer;
+        }
+        else {
+            globalSearch->stop();
+            engineThinking = false;
+            enginePondering = false;
+            speculation.clear();
+            speculativeCurrent = -1;
+            replyReady = false;
+            expectedReply = NO_MOVE;
+        }
+        std::cout << " " << (engineEnabled ? "  " : "")
+            << (engineEnabled ? (engineColor == PieceColor::WHITE ? "WHITE" : "BLACK") : "") << std::endl;
+    }
 }
 
 void processInput(GLFWwindow* window)
@@ -335,6 +632,16 @@ int main() {
     ChessBoard chessBoard;
     globalChessBoard = &chessBoard;
 
+    //    
+    Search search;
+    search.setThreads((int)std::max(1u, std::thread::hardware_concurrency()) - 1);
+    globalSearch = &search;
+
+    //  :       
+    if (loadNetwork("nnue.bin")) {
+        std::cout << "  nnue.bin,  " << nnueSimdName(NnueSimdLevel) << std::endl;
+    }
+
     std::vector<Cell> cells;
     const int gridSize = 8;
     const float cellSize = 1.0f / gridSize; //  -1  1   
@@ -503,6 +810,7 @@ int main() {
         lastFrame = currentFrame;
 
         updateFlipAnimation(deltaTime);
+        updateEngine();
 
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -545,25 +853,16 @@ int main() {
         glUniform1f(glGetUniformLocation(ourShader.Program, "flipTransition"), flipTransition);
         glUniform1i(glGetUniformLocation(ourShader.Program, "boardFlipped"), boardFlipped ? 1 : 0);
 
-        auto& board = chessBoard.getBoard();
-        for (int y = 0; y < 8; y++) {
-            for (int x = 0; x < 8; x++) {
-                ChessPiece* piece = board[y][x];
-                if (piece != nullptr && piece != draggedPiece) {
-                    Position renderPos(x, y);
-                    if (boardFlipped) {
-                        renderPos.x = 7 - x;
-                        renderPos.y = 7 - y;
-                    }
+        Bitboard occupied = chessBoard.getState().occupied();
+        while (occupied) {
+            int sq = popLsb(occupied);
+            ChessPiece* piece = chessBoard.getPiece(sq);
+            if (piece != draggedPiece) {
+                float renderX, renderY;
+                boardToRenderCoords(squareToPosition(sq), renderX, renderY);
 
-                    float renderX, renderY;
-                    const float cellSize = 1.0f / 8.0f;
-                    renderX = -0.5f + cellSize * renderPos.x + cellSize / 2.0f;
-                    renderY = -0.5f + cellSize * renderPos.y + cellSize / 2.0f;
-
-                    piece->setRenderPosition(renderX, renderY);
-                    piece->render(ourShader);
-                }
+                piece->setRenderPosition(renderX, renderY);
+                piece->render(ourShader);
             }
         }
 
@@ -585,6 +884,8 @@ int main() {
     }
 
     // 
+    search.stop();
+    globalSearch = nullptr;
     glDeleteVertexArrays(1, &VAO2);
     glDeleteBuffers(1, &VBO2);
     glDeleteBuffers(1, &EBO2);
@@ -0,0 +1,99 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+
+#include "bitboard.h"
+
+//   16 : 6  , 6  , 4  
+typedef uint16_t Move;
+
+const Move NO_MOVE = 0;
+
+enum MoveFlag : uint8_t {
+    FLAG_QUIET = 0,
+    FLAG_DOUBLE_PUSH = 1,
+    FLAG_KING_CASTLE = 2,
+    FLAG_QUEEN_CASTLE = 3,
+    FLAG_CAPTURE = 4,
+    FLAG_EP_CAPTURE = 5,
+    FLAG_PROMOTION = 8,
+    FLAG_PROMO_KNIGHT = 8,
+    FLAG_PROMO_BISHOP = 9,
+    FLAG_PROMO_ROOK = 10,
+    FLAG_PROMO_QUEEN = 11,
+    FLAG_PROMO_KNIGHT_CAPTURE = 12,
+    FLAG_PROMO_BISHOP_CAPTURE = 13,
+    FLAG_PROMO_ROOK_CAPTURE = 14,
+    FLAG_PROMO_QUEEN_CAPTURE = 15
+};
+
+inline Move makeMove(int from, int to, int flags = FLAG_QUIET) {
+    return Move(from | (to << 6) | (flags << 12));
+}
+
+inline int fromSquare(Move m) {
+    return m & 63;
+}
+
+inline int toSquare(Move m) {
+    return (m >> 6) & 63;
+}
+
+inline int moveFlags(Move m) {
+    return m >> 12;
+}
+
+inline bool isCapture(Move m) {
+    return (moveFlags(m) & FLAG_CAPTURE) != 0;
+}
+
+inline bool isPromotion(Move m) {
+    return (moveFlags(m) & FLAG_PROMOTION) != 0;
+}
+
+//      ,    .
+// 512  :    ,  218   .
+struct MoveList {
+    static const int CAPACITY = 512;
+
+    Move moves[CAPACITY];
+    int count;
+
+    MoveList() : count(0) {}
+
+    void add(Move m) {
+        moves[count++] = m;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    Move operator[](int i) const {
+        return moves[i];
+    }
+
+    const Move* begin() const {
+        return moves;
+    }
+
+    const Move* end() const {
+        return moves + count;
+    }
+
+    Move find(int from, int to) const {
+        for (int i = 0; i < count; i++) {
+            if (fromSquare(moves[i]) == from && toSquare(moves[i]) == to) {
+                return moves[i];
+            }
+        }
+        return NO_MOVE;
+    }
+};
+
+#endif // MOVE_H
@@ -0,0 +1,218 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include <array>
+#include <utility>
+
+#include "bitboard.h"
+#include "board_state.h"
+#include "attacks.h"
+#include "move.h"
+
+//       
+// :    32  ( ) 
+//    ,       .
+
+inline Bitboard pawnPushTargets(int us, int sq, Bitboard empty, bool firstMove) {
+    Bitboard from = squareBB(sq);
+
+    // 
+    Bitboard push = (us == 0 ? from << 8 : from >> 8) & empty;
+
+    //    
+    Bitboard doublePush = (us == 0 ? push << 8 : push >> 8) & empty;
+    return push | (firstMove ? doublePush : 0);
+}
+
+template<uint8_t Caps>
+Bitboard pieceTargets(const BoardState& board, int sq, int us, bool firstMove) {
+    Bitboard occupied = board.occupied();
+    Bitboard targets = 0;
+
+    if constexpr ((Caps & CAP_ROOK) != 0) {
+        targets |= rookAttacks(sq, occupied);
+    }
+    if constexpr ((Caps & CAP_BISHOP) != 0) {
+        targets |= bishopAttacks(sq, occupied);
+    }
+    if constexpr ((Caps & CAP_KNIGHT) != 0) {
+        targets |= KnightAttacks[sq];
+    }
+    if constexpr ((Caps & CAP_KING) != 0) {
+        targets |= KingAttacks[sq];
+    }
+    targets &= ~board.byColor[us];
+
+    if constexpr ((Caps & CAP_PAWN) != 0) {
+        targets |= PawnAttacks[us][sq] & board.byColor[us ^ 1];
+        targets |= pawnPushTargets(us, sq, ~occupied, firstMove);
+    }
+    return targets;
+}
+
+typedef Bitboard (*PieceTargetsFn)(const BoardState& board, int sq, int us, bool firstMove);
+
+template<size_t... Caps>
+constexpr std::array<PieceTargetsFn, sizeof...(Caps)> makePieceTargetTable(std::index_sequence<Caps...>) {
+    return { { &pieceTargets<uint8_t(Caps)>... } };
+}
+
+inline constexpr std::array<PieceTargetsFn, 32> PieceTargetTable =
+    makePieceTargetTable(std::make_index_sequence<32>());
+
+//      sq
+inline Bitboard pieceTargets(const BoardState& board, int sq) {
+    PieceCode code = board.pieceOn(sq);
+    bool firstMove = (board.unmoved & squareBB(sq)) != 0;
+    return PieceTargetTable[pieceCaps(code)](board, sq, colorIndex(pieceColor(code)), firstMove);
+}
+
+//        ,  
+//   (   ,   )
+inline void addMoves(const BoardState& board, int from, Bitboard targets, MoveList& list) {
+    PieceCode code = board.pieceOn(from);
+    int us = colorIndex(pieceColor(code));
+    Bitboard enemies = board.byColor[us ^ 1];
+
+    if (pieceCaps(code) == CAP_PAWN) {
+        Bitboard promotions = targets & (us == 0 ? RANK_8_BB : RANK_1_BB);
+        targets ^= promotions;
+        while (promotions) {
+            int to = popLsb(promotions);
+            int capture = (enemies & squareBB(to)) ? FLAG_CAPTURE : 0;
+            for (int flags = FLAG_PROMO_QUEEN; flags >= FLAG_PROMO_KNIGHT; flags--) {
+                list.add(makeMove(from, to, flags | capture));
+            }
+        }
+    }
+
+    //          
+    int doublePushSq = NO_SQUARE;
+    if ((pieceCaps(code) & CAP_PAWN) && (board.unmoved & squareBB(from))) {
+        doublePushSq = us == 0 ? from + 16 : from - 16;
+    }
+
+    while (targets) {
+        int to = popLsb(targets);
+        int flags = (enemies & squareBB(to)) ? FLAG_CAPTURE : FLAG_QUIET;
+        if (to == doublePushSq && flags == FLAG_QUIET) {
+            flags = FLAG_DOUBLE_PUSH;
+        }
+        list.add(makeMove(from, to, flags));
+    }
+}
+
+inline void generatePieceMoves(const BoardState& board, int sq, MoveList& list) {
+    addMoves(board, sq, pieceTargets(board, sq), list);
+}
+
+//    ,  
+inline void generateMoves(const BoardState& board, MoveList& list) {
+    Bitboard own = board.byColor[board.sideToMove];
+    while (own) {
+        generatePieceMoves(board, popLsb(own), list);
+    }
+}
+
+//     make/unmake:    
+//     ,     
+//      .     .
+// CapturesOnly -   :    
+// ,      .
+template<bool CapturesOnly>
+void generateLegal(const BoardState& board, MoveList& list) {
+    int us = board.sideToMove;
+    Bitboard own = board.byColor[us];
+    Bitboard enemies = board.byColor[us ^ 1];
+    Bitboard occupied = own | enemies;
+    int ksq = board.kingSquare(us);
+
+    Bitboard checkers = 0;
+    Bitboard pinned = 0;
+    Bitboard checkMask = ~0ULL;
+    Bitboard movers = own;
+    Bitboard targetMask = CapturesOnly ? enemies : ~0ULL;
+
+    if (ksq != NO_SQUARE) {
+        checkers = board.attackersTo(ksq, occupied) & enemies;
+
+        Bitboard snipers = ((rookAttacks(ksq, 0) & board.piecesWith(CAP_ROOK))
+            | (bishopAttacks(ksq, 0) & board.piecesWith(CAP_BISHOP))) & enemies;
+        while (snipers) {
+            Bitboard between = BetweenBB[ksq][popLsb(snipers)] & occupied;
+            if (between && !(between & (between - 1))) {
+                pinned |= between & own;
+            }
+        }
+
+        //      ,      
+        Bitboard withoutKing = occupied ^ squareBB(ksq);
+        Bitboard kingTargets = KingAttacks[ksq] & ~own & targetMask;
+        while (kingTargets) {
+            int to = popLsb(kingTargets);
+            if (!(board.attackersTo(to, withoutKing) & enemies)) {
+                list.add(makeMove(ksq, to, (enemies & squareBB(to)) ? FLAG_CAPTURE : FLAG_QUIET));
+            }
+        }
+
+        //   -   
+        if (checkers & (checkers - 1)) return;
+
+        if (checkers) {
+            checkMask = BetweenBB[ksq][lsb(checkers)] | checkers;
+        }
+        else if (!CapturesOnly && ksq == (us == 0 ? 4 : 60)) {
+            uint8_t rights = board.castling & (us == 0 ? (WHITE_OO | WHITE_OOO) : (BLACK_OO | BLACK_OOO));
+            if ((rights & (WHITE_OO | BLACK_OO)) && !(BetweenBB[ksq][ksq + 3] & occupied)
+                && !(board.attackersTo(ksq + 1, occupied) & enemies)
+                && !(board.attackersTo(ksq + 2, occupied) & enemies)) {
+                list.add(makeMove(ksq, ksq + 2, FLAG_KING_CASTLE));
+            }
+            if ((rights & (WHITE_OOO | BLACK_OOO)) && !(BetweenBB[ksq][ksq - 4] & occupied)
+                && !(board.attackersTo(ksq - 1, occupied) & enemies)
+                && !(board.attackersTo(ksq - 2, occupied) & enemies)) {
+                list.add(makeMove(ksq, ksq - 2, FLAG_QUEEN_CASTLE));
+            }
+        }
+
+        movers ^= squareBB(ksq);
+    }
+
+    while (movers) {
+        int sq = popLsb(movers);
+        Bitboard allowed = targetMask;
+        if (CapturesOnly && pieceCaps(board.pieceOn(sq)) == CAP_PAWN) {
+            allowed |= us == 0 ? RANK_8_BB : RANK_1_BB;
+        }
+        Bitboard targets = pieceTargets(board, sq) & checkMask & allowed;
+        if (pinned & squareBB(sq)) {
+            targets &= LineBB[ksq][sq];
+        }
+        addMoves(board, sq, targets, list);
+    }
+
+    //         :
+    //      ,     
+    if (board.epSquare != NO_SQUARE) {
+        int ep = board.epSquare;
+        int capSq = us == 0 ? ep - 8 : ep + 8;
+        Bitboard capturers = PawnAttacks[us ^ 1][ep] & board.piecesWith(CAP_PAWN) & own;
+        while (capturers) {
+            int from = popLsb(capturers);
+            Bitboard after = (occupied ^ squareBB(from) ^ squareBB(capSq)) | squareBB(ep);
+            if (ksq == NO_SQUARE || !(board.attackersTo(ksq, after) & enemies & ~squareBB(capSq))) {
+                list.add(makeMove(from, ep, FLAG_EP_CAPTURE));
+            }
+        }
+    }
+}
+
+inline void generateLegalMoves(const BoardState& board, MoveList& list) {
+    generateLegal<false>(board, list);
+}
+
+inline void generateLegalCaptures(const BoardState& board, MoveList& list) {
+    generateLegal<true>(board, list);
+}
+
+#endif // MOVEGEN_H
@@ -0,0 +1,134 @@
+#ifndef MOVEPICK_H
+#define MOVEPICK_H
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "bitboard.h"
+#include "board_state.h"
+#include "movegen.h"
+#include "move.h"
+#include "see.h"
+
+//          -  
+//   ,   -    .
+struct HistoryTable {
+    static const int MAX = 16384;
+
+    int16_t table[PIECE_CODE_NB][SQUARE_NB];
+
+    void clear() {
+        std::memset(table, 0, sizeof(table));
+    }
+
+    //    ,     
+    void age() {
+        for (auto& row : table) {
+            for (int16_t& h : row) h /= 2;
+        }
+    }
+
+    int get(PieceCode piece, int to) const {
+        return table[piece][to];
+    }
+
+    //   :     [-MAX, MAX]
+    void update(PieceCode piece, int to, int bonus) {
+        int16_t& h = table[piece][to];
+        h += int16_t(bonus - h * (bonus < 0 ? -bonus : bonus) / MAX);
+    }
+};
+
+//       :   , 
+//  SEE     MVV-LVA, ,  ,  
+//      .
+//   -      ,   
+//      .
+class MovePicker {
+public:
+    MovePicker(const BoardState& board, Move ttMove, const Move* killers, Move counterMove,
+        const HistoryTable& history) {
+        generateLegalMoves(board, moves);
+
+        for (int i = 0; i < moves.size(); i++) {
+            Move m = moves[i];
+            if (m == ttMove) {
+                scores[i] = TT_SCORE;
+            }
+            else if (isCapture(m) || isPromotion(m)) {
+                scores[i] = (see(board, m) >= 0 ? CAPTURE_SCORE : BAD_CAPTURE_SCORE) + captureScore(board, m);
+            }
+            else if (killers != nullptr && m == killers[0]) {
+                scores[i] = KILLER_SCORE;
+            }
+            else if (killers != nullptr && m == killers[1]) {
+                scores[i] = KILLER_SCORE - 1;
+            }
+            else if (m == counterMove) {
+                scores[i] = KILLER_SCORE - 2;
+            }
+            else {
+                scores[i] = history.get(board.pieceOn(fromSquare(m)), toSquare(m));
+            }
+        }
+    }
+
+    //   :     MVV-LVA,
+    //    -    
+    MovePicker(const BoardState& board, Move ttMove) {
+        if (board.inCheck()) {
+            generateLegalMoves(board, moves);
+        }
+        else {
+            generateLegalCaptures(board, moves);
+        }
+
+        for (int i = 0; i < moves.size(); i++) {
+            Move m = moves[i];
+            scores[i] = m == ttMove ? TT_SCORE
+                : (isCapture(m) || isPromotion(m)) ? CAPTURE_SCORE + captureScore(board, m) : 0;
+        }
+    }
+
+    Move next() {
+        if (current >= moves.size()) return NO_MOVE;
+
+        int best = current;
+        for (int i = current + 1; i < moves.size(); i++) {
+            if (scores[i] > scores[best]) best = i;
+        }
+        std::swap(moves.moves[best], moves.moves[current]);
+        std::swap(scores[best], scores[current]);
+        return moves[current++];
+    }
+
+    int size() const {
+        return moves.size();
+    }
+
+private:
+    static const int TT_SCORE = 1 << 30;
+    static const int CAPTURE_SCORE = 1 << 28;
+    static const int KILLER_SCORE = 1 << 27;
+    static const int BAD_CAPTURE_SCORE = -(1 << 28);
+
+    MoveList moves;
+    int scores[MoveList::CAPACITY];
+    int current = 0;
+
+    //   ,    ; 
+    //    
+    static int captureScore(const BoardState& board, Move m) {
+        int flags = moveFlags(m);
+        PieceCode attacker = board.pieceOn(fromSquare(m));
+        int victim = flags == FLAG_EP_CAPTURE ? CapabilityValue[lsb(CAP_PAWN)] : pieceValue(board.pieceOn(toSquare(m)));
+        if (isPromotion(m)) {
+            victim += pieceValue(makePieceCode(pieceColor(attacker), BoardState::promotionCaps(m)));
+        }
+        int attackerValue = pieceCaps(attacker) == CAP_KING ? 4096 : pieceValue(attacker);
+        return victim * 16 - attackerValue / 8;
+    }
+};
+
+#endif // MOVEPICK_H
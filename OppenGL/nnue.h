@@ -0,0 +1,334 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "board_state.h"
+#include "move.h"
+#include "nnue_simd.h"
+
+//       (NNUE).
+//
+//  - HalfKP,   :   
+// ()  -     , 
+//  , /    .   
+//     ,  -   , 
+//       . 
+//    .    
+//   .
+
+const int NNUE_INPUTS = SQUARE_NB * CAP_COUNT * 2 * SQUARE_NB;
+
+//     ,   
+const int NNUE_OUTPUT_SCALE = 16;
+//     int32    uint8 
+const int NNUE_WEIGHT_SHIFT = 6;
+
+//  : "OGNN",    (uint32),   little-endian:
+// int16    , int32   int8  512->32,
+// 32->32  32->1.
+const uint32_t NNUE_MAGIC = 0x4E4E474F;
+const uint32_t NNUE_VERSION = 1;
+
+struct NnueNetwork {
+    bool loaded = false;
+    std::vector<int16_t> ftBias;
+    std::vector<int16_t> ftWeights;
+    std::vector<int32_t> bias1;
+    std::vector<int8_t> weights1;
+    std::vector<int32_t> bias2;
+    std::vector<int8_t> weights2;
+    int32_t bias3 = 0;
+    std::vector<int8_t> weights3;
+};
+
+inline NnueNetwork Network;
+inline NnueSimd NnueSimdLevel = NnueSimd::SCALAR;
+inline NnueKernels Nnue = nnueKernelsFor(NnueSimd::SCALAR);
+
+inline bool initNnue() {
+    NnueSimdLevel = detectNnueSimd();
+    Nnue = nnueKernelsFor(NnueSimdLevel);
+    return true;
+}
+
+inline void ensureNnueInitialized() {
+    static const bool initialized = initNnue();
+    (void)initialized;
+}
+
+//     -     
+inline void setNnueSimd(NnueSimd simd) {
+    ensureNnueInitialized();
+    NnueSimdLevel = simd;
+    Nnue = nnueKernelsFor(simd);
+}
+
+template<typename T>
+inline bool readNnueArray(std::istream& in, std::vector<T>& v, size_t count) {
+    v.resize(count);
+    in.read(reinterpret_cast<char*>(v.data()), std::streamsize(count * sizeof(T)));
+    return bool(in);
+}
+
+inline std::vector<int8_t> groupNnueWeights(const std::vector<int8_t>& rows, int inDim, int outDim) {
+    std::vector<int8_t> grouped(rows.size());
+    for (int o = 0; o < outDim; o++) {
+        for (int i = 0; i < inDim; i++) {
+            grouped[(i / 4 * outDim + o) * 4 + i % 4] = rows[o * inDim + i];
+        }
+    }
+    return grouped;
+}
+
+//    .      .
+inline bool loadNetwork(const std::string& path) {
+    ensureNnueInitialized();
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t header[6];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != NNUE_MAGIC || header[1] != NNUE_VERSION
+        || header[2] != uint32_t(NNUE_INPUTS) || header[3] != uint32_t(NNUE_HALF)
+        || header[4] != uint32_t(NNUE_L1) || header[5] != uint32_t(NNUE_L2)) {
+        return false;
+    }
+
+    NnueNetwork net;
+    if (!readNnueArray(in, net.ftBias, NNUE_HALF)
+        || !readNnueArray(in, net.ftWeights, size_t(NNUE_INPUTS) * NNUE_HALF)
+        || !readNnueArray(in, net.bias1, NNUE_L1)
+        || !readNnueArray(in, net.weights1, size_t(NNUE_L1) * 2 * NNUE_HALF)
+        || !readNnueArray(in, net.bias2, NNUE_L2)
+        || !readNnueArray(in, net.weights2, size_t(NNUE_L2) * NNUE_L1)) {
+        return false;
+    }
+    in.read(reinterpret_cast<char*>(&net.bias3), sizeof(net.bias3));
+    if (!in || !readNnueArray(in, net.weights3, NNUE_L2)) {
+        return false;
+    }
+
+    //     ,      
+    net.weights1 = groupNnueWeights(net.weights1, 2 * NNUE_HALF, NNUE_L1);
+    net.weights2 = groupNnueWeights(net.weights2, NNUE_L1, NNUE_L2);
+
+    net.loaded = true;
+    Network = std::move(net);
+    return true;
+}
+
+inline bool networkLoaded() {
+    return Network.loaded;
+}
+
+// kingSq     
+inline int nnueFeature(int perspective, int kingSq, int cap, PieceCode code, int sq) {
+    int relColor = colorIndex(pieceColor(code)) != perspective;
+    int relSq = perspective == 0 ? sq : sq ^ 56;
+    return ((kingSq * CAP_COUNT + cap) * 2 + relColor) * SQUARE_NB + relSq;
+}
+
+inline int nnueKingSquare(const BoardState& board, int perspective) {
+    int ksq = board.kingSquare(perspective);
+    if (ksq == NO_SQUARE) ksq = 0;
+    return perspective == 0 ? ksq : ksq ^ 56;
+}
+
+//      :    (, ,
+//   ;  -     ).
+struct DirtyPieces {
+    int count;
+    PieceCode code[3];
+    uint8_t from[3];
+    uint8_t to[3];
+
+    void add(PieceCode c, int f, int t) {
+        code[count] = c;
+        from[count] = uint8_t(f);
+        to[count] = uint8_t(t);
+        count++;
+    }
+};
+
+struct alignas(64) Accumulator {
+    int16_t values[2][NNUE_HALF];
+    bool computed[2];
+    //     -   
+    bool kingMoved[2];
+    DirtyPieces dirty;
+};
+
+//     . push/pop  , 
+// ;       
+//   ,        .
+class AccumulatorStack {
+public:
+    void reset() {
+        top = 0;
+        entries[0].computed[0] = entries[0].computed[1] = false;
+    }
+
+    //   board.make(m, undo)
+    void push(const BoardState& board, Move m, const UndoRecord& undo) {
+        Accumulator& e = entries[++top];
+        int us = board.sideToMove ^ 1;
+        int from = fromSquare(m);
+        int to = toSquare(m);
+        int flags = moveFlags(m);
+
+        e.computed[0] = e.computed[1] = false;
+        e.kingMoved[us] = pieceCaps(undo.moved) == CAP_KING;
+        e.kingMoved[us ^ 1] = false;
+        e.dirty.count = 0;
+
+        if (flags & FLAG_PROMOTION) {
+            e.dirty.add(undo.moved, from, NO_SQUARE);
+            e.dirty.add(board.pieceOn(to), NO_SQUARE, to);
+        }
+        else {
+            e.dirty.add(undo.moved, from, to);
+        }
+
+        if (flags == FLAG_EP_CAPTURE) {
+            e.dirty.add(undo.captured, us == 0 ? to - 8 : to + 8, NO_SQUARE);
+        }
+        else if (undo.captured != NO_PIECE) {
+            e.dirty.add(undo.captured, to, NO_SQUARE);
+        }
+        else if (flags == FLAG_KING_CASTLE || flags == FLAG_QUEEN_CASTLE) {
+            int rookFrom = flags == FLAG_KING_CASTLE ? from + 3 : from - 4;
+            int rookTo = flags == FLAG_KING_CASTLE ? from + 1 : from - 1;
+            e.dirty.add(board.pieceOn(rookTo), rookFrom, rookTo);
+        }
+    }
+
+    //  :   
+    void pushNull() {
+        Accumulator& e = entries[++top];
+        e.computed[0] = e.computed[1] = false;
+        e.kingMoved[0] = e.kingMoved[1] = false;
+        e.dirty.count = 0;
+    }
+
+    void pop() {
+        top--;
+    }
+
+    //   ,    
+    const Accumulator& current(const BoardState& board) {
+        for (int p = 0; p < 2; p++) {
+            if (!entries[top].computed[p]) {
+                compute(board, p);
+            }
+        }
+        return entries[top];
+    }
+
+    //     
+    static const int CAPACITY = 128;
+
+private:
+    Accumulator entries[CAPACITY];
+    int top = 0;
+
+    void compute(const BoardState& board, int p) {
+        int ksq = nnueKingSquare(board, p);
+
+        //   ;     -   
+        int i = top;
+        while (!entries[i].computed[p]) {
+            if (i == 0 || entries[i].kingMoved[p]) {
+                refresh(board, p, ksq);
+                return;
+            }
+            i--;
+        }
+
+        int add[NNUE_MAX_FEATURES];
+        int sub[NNUE_MAX_FEATURES];
+        for (i++; i <= top; i++) {
+            int addCount = 0;
+            int subCount = 0;
+            const DirtyPieces& d = entries[i].dirty;
+            for (int k = 0; k < d.count; k++) {
+                uint8_t caps = pieceCaps(d.code[k]);
+                if (caps == CAP_KING) continue;
+                for (int cap = 0; cap < CAP_COUNT; cap++) {
+                    if (!(caps & (1 << cap))) continue;
+                    if (d.from[k] != NO_SQUARE) sub[subCount++] = nnueFeature(p, ksq, cap, d.code[k], d.from[k]);
+                    if (d.to[k] != NO_SQUARE) add[addCount++] = nnueFeature(p, ksq, cap, d.code[k], d.to[k]);
+                }
+            }
+            Nnue.update(entries[i].values[p], entries[i - 1].values[p], Network.ftWeights.data(),
+                add, addCount, sub, subCount);
+            entries[i].computed[p] = true;
+        }
+    }
+
+    void refresh(const BoardState& board, int p, int ksq) {
+        int16_t* dst = entries[top].values[p];
+        const int16_t* src = Network.ftBias.data();
+        int add[NNUE_MAX_FEATURES];
+        int addCount = 0;
+
+        Bitboard b = board.occupied();
+        while (b) {
+            int sq = popLsb(b);
+            PieceCode code = board.pieceOn(sq);
+            uint8_t caps = pieceCaps(code);
+            if (caps == CAP_KING) continue;
+            for (int cap = 0; cap < CAP_COUNT; cap++) {
+                if (caps & (1 << cap)) add[addCount++] = nnueFeature(p, ksq, cap, code, sq);
+            }
+            //     -  
+            if (addCount > NNUE_MAX_FEATURES - CAP_COUNT) {
+                Nnue.update(dst, src, Network.ftWeights.data(), add, addCount, nullptr, 0);
+                src = dst;
+                addCount = 0;
+            }
+        }
+        Nnue.update(dst, src, Network.ftWeights.data(), add, addCount, nullptr, 0);
+        entries[top].computed[p] = true;
+    }
+};
+
+inline void nnueActivate(const int32_t* in, uint8_t* out, int count) {
+    for (int i = 0; i < count; i++) {
+        int v = in[i] >> NNUE_WEIGHT_SHIFT;
+        out[i] = uint8_t(v < 0 ? 0 : v > 127 ? 127 : v);
+    }
+}
+
+//        
+inline int evaluateNnue(const BoardState& board, AccumulatorStack& stack) {
+    const Accumulator& acc = stack.current(board);
+    int us = board.sideToMove;
+
+    alignas(64) uint8_t input[2 * NNUE_HALF];
+    Nnue.clip(acc.values[us], input);
+    Nnue.clip(acc.values[us ^ 1], input + NNUE_HALF);
+
+    alignas(64) int32_t sums1[NNUE_L1];
+    alignas(64) uint8_t hidden1[NNUE_L1];
+    Nnue.affine(input, 2 * NNUE_HALF, Network.weights1.data(), Network.bias1.data(), NNUE_L1, sums1);
+    nnueActivate(sums1, hidden1, NNUE_L1);
+
+    alignas(64) int32_t sums2[NNUE_L2];
+    alignas(64) uint8_t hidden2[NNUE_L2];
+    Nnue.affine(hidden1, NNUE_L1, Network.weights2.data(), Network.bias2.data(), NNUE_L2, sums2);
+    nnueActivate(sums2, hidden2, NNUE_L2);
+
+    int32_t output = Network.bias3;
+    for (int i = 0; i < NNUE_L2; i++) {
+        output += hidden2[i] * Network.weights3[i];
+    }
+    return output / NNUE_OUTPUT_SCALE;
+}
+
+#endif // NNUE_H
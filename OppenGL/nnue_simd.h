@@ -0,0 +1,284 @@
+#ifndef NNUE_SIMD_H
+#define NNUE_SIMD_H
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NNUE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//  GCC/Clang       
+// ,    :  ,  -  .
+// MSVC    .
+#if defined(__GNUC__)
+#define NNUE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NNUE_TARGET(isa)
+#endif
+
+//  :  -> 2 x 256 -> 32 -> 32 -> 1
+const int NNUE_HALF = 256;
+const int NNUE_L1 = 32;
+const int NNUE_L2 = 32;
+
+//       
+const int NNUE_MAX_FEATURES = 192;
+
+enum class NnueSimd {
+    SCALAR,
+    SSE41,
+    AVX2
+};
+
+//  .    - int16 (  ). 
+//  - int8      :
+// w[(i / 4 * outDim + o) * 4 + i % 4],      
+//      .    -
+// uint8  [0, 127].
+struct NnueKernels {
+    // dst = src +   add -   sub,  NNUE_HALF 
+    void (*update)(int16_t* dst, const int16_t* src, const int16_t* weights,
+        const int* add, int addCount, const int* sub, int subCount);
+    //    [0, 127], NNUE_HALF 
+    void (*clip)(const int16_t* acc, uint8_t* out);
+    // out[o] = bias[o] + sum in[i] * w[i][o]; inDim  32, outDim = 32.
+    //     -    
+    void (*affine)(const uint8_t* in, int inDim, const int8_t* weights,
+        const int32_t* bias, int outDim, int32_t* out);
+};
+
+inline void updateScalar(int16_t* dst, const int16_t* src, const int16_t* weights,
+    const int* add, int addCount, const int* sub, int subCount) {
+    if (dst != src) {
+        std::memcpy(dst, src, NNUE_HALF * sizeof(int16_t));
+    }
+    for (int f = 0; f < addCount; f++) {
+        const int16_t* row = weights + size_t(add[f]) * NNUE_HALF;
+        for (int i = 0; i < NNUE_HALF; i++) dst[i] += row[i];
+    }
+    for (int f = 0; f < subCount; f++) {
+        const int16_t* row = weights + size_t(sub[f]) * NNUE_HALF;
+        for (int i = 0; i < NNUE_HALF; i++) dst[i] -= row[i];
+    }
+}
+
+inline void clipScalar(const int16_t* acc, uint8_t* out) {
+    for (int i = 0; i < NNUE_HALF; i++) {
+        out[i] = uint8_t(acc[i] < 0 ? 0 : acc[i] > 127 ? 127 : acc[i]);
+    }
+}
+
+inline void affineScalar(const uint8_t* in, int inDim, const int8_t* weights,
+    const int32_t* bias, int outDim, int32_t* out) {
+    for (int o = 0; o < outDim; o++) out[o] = bias[o];
+    for (int i = 0; i < inDim; i++) {
+        if (in[i] == 0) continue;
+        const int8_t* w = weights + (i / 4 * outDim) * 4 + i % 4;
+        for (int o = 0; o < outDim; o++) out[o] += in[i] * w[o * 4];
+    }
+}
+
+#ifdef NNUE_X86
+
+//       -   
+//    
+struct NnueBitIndices {
+    uint16_t index[256][8];
+    uint8_t count[256];
+};
+
+inline NnueBitIndices buildNnueBitIndices() {
+    NnueBitIndices t = {};
+    for (int mask = 0; mask < 256; mask++) {
+        for (int j = 0; j < 8; j++) {
+            if (mask & (1 << j)) t.index[mask][t.count[mask]++] = uint16_t(j);
+        }
+    }
+    return t;
+}
+
+inline const NnueBitIndices NnueBits = buildNnueBitIndices();
+
+NNUE_TARGET("sse4.1")
+inline void updateSse41(int16_t* dst, const int16_t* src, const int16_t* weights,
+    const int* add, int addCount, const int* sub, int subCount) {
+    //   :    ,   
+    //  
+    for (int i = 0; i < NNUE_HALF; i += 8) {
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        for (int f = 0; f < addCount; f++) {
+            r = _mm_add_epi16(r, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + size_t(add[f]) * NNUE_HALF + i)));
+        }
+        for (int f = 0; f < subCount; f++) {
+            r = _mm_sub_epi16(r, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + size_t(sub[f]) * NNUE_HALF + i)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+    }
+}
+
+NNUE_TARGET("sse4.1")
+inline void clipSse41(const int16_t* acc, uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < NNUE_HALF; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_max_epi8(_mm_packs_epi16(a, b), zero));
+    }
+}
+
+//         , 
+//           
+//   32  -    .
+NNUE_TARGET("sse4.1")
+inline void affineSse41(const uint8_t* in, int inDim, const int8_t* weights,
+    const int32_t* bias, int outDim, int32_t* out) {
+    (void)outDim;
+    uint16_t groups[2 * NNUE_HALF / 4 + 8];
+    int count = 0;
+    for (int i = 0; i < inDim; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, _mm_setzero_si128())));
+        __m128i idx = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(NnueBits.index[mask]));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(groups + count), _mm_add_epi16(idx, _mm_set1_epi16(short(i / 4))));
+        count += NnueBits.count[mask];
+    }
+
+    //  -  ,     
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i* b = reinterpret_cast<const __m128i*>(bias);
+    __m128i s0 = _mm_loadu_si128(b), s1 = _mm_loadu_si128(b + 1), s2 = _mm_loadu_si128(b + 2), s3 = _mm_loadu_si128(b + 3);
+    __m128i s4 = _mm_loadu_si128(b + 4), s5 = _mm_loadu_si128(b + 5), s6 = _mm_loadu_si128(b + 6), s7 = _mm_loadu_si128(b + 7);
+    for (int n = 0; n < count; n++) {
+        int32_t word;
+        std::memcpy(&word, in + groups[n] * 4, 4);
+        __m128i x = _mm_set1_epi32(word);
+        const __m128i* w = reinterpret_cast<const __m128i*>(weights + groups[n] * 32 * 4);
+        s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w)), ones));
+        s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 1)), ones));
+        s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 2)), ones));
+        s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 3)), ones));
+        s4 = _mm_add_epi32(s4, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 4)), ones));
+        s5 = _mm_add_epi32(s5, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 5)), ones));
+        s6 = _mm_add_epi32(s6, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 6)), ones));
+        s7 = _mm_add_epi32(s7, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(w + 7)), ones));
+    }
+    __m128i* o = reinterpret_cast<__m128i*>(out);
+    _mm_storeu_si128(o, s0);
+    _mm_storeu_si128(o + 1, s1);
+    _mm_storeu_si128(o + 2, s2);
+    _mm_storeu_si128(o + 3, s3);
+    _mm_storeu_si128(o + 4, s4);
+    _mm_storeu_si128(o + 5, s5);
+    _mm_storeu_si128(o + 6, s6);
+    _mm_storeu_si128(o + 7, s7);
+}
+
+NNUE_TARGET("avx2")
+inline void updateAvx2(int16_t* dst, const int16_t* src, const int16_t* weights,
+    const int* add, int addCount, const int* sub, int subCount) {
+    for (int i = 0; i < NNUE_HALF; i += 16) {
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        for (int f = 0; f < addCount; f++) {
+            r = _mm256_add_epi16(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + size_t(add[f]) * NNUE_HALF + i)));
+        }
+        for (int f = 0; f < subCount; f++) {
+            r = _mm256_sub_epi16(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + size_t(sub[f]) * NNUE_HALF + i)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
+    }
+}
+
+NNUE_TARGET("avx2")
+inline void clipAvx2(const int16_t* acc, uint8_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HALF; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + 16));
+        //    128- ,  
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_max_epi8(packed, zero));
+    }
+}
+
+NNUE_TARGET("avx2")
+inline void affineAvx2(const uint8_t* in, int inDim, const int8_t* weights,
+    const int32_t* bias, int outDim, int32_t* out) {
+    (void)outDim;
+    uint16_t groups[2 * NNUE_HALF / 4 + 8];
+    int count = 0;
+    for (int i = 0; i < inDim; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, _mm256_setzero_si256())));
+        //  :    ,     
+        __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(NnueBits.index[mask]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(groups + count), _mm_add_epi16(idx, _mm_set1_epi16(short(i / 4))));
+        count += NnueBits.count[mask];
+    }
+
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i* b = reinterpret_cast<const __m256i*>(bias);
+    __m256i s0 = _mm256_loadu_si256(b), s1 = _mm256_loadu_si256(b + 1);
+    __m256i s2 = _mm256_loadu_si256(b + 2), s3 = _mm256_loadu_si256(b + 3);
+    for (int n = 0; n < count; n++) {
+        int32_t word;
+        std::memcpy(&word, in + groups[n] * 4, 4);
+        __m256i x = _mm256_set1_epi32(word);
+        const __m256i* w = reinterpret_cast<const __m256i*>(weights + groups[n] * 32 * 4);
+        s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(w)), ones));
+        s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(w + 1)), ones));
+        s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(w + 2)), ones));
+        s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(w + 3)), ones));
+    }
+    __m256i* o = reinterpret_cast<__m256i*>(out);
+    _mm256_storeu_si256(o, s0);
+    _mm256_storeu_si256(o + 1, s1);
+    _mm256_storeu_si256(o + 2, s2);
+    _mm256_storeu_si256(o + 3, s3);
+}
+
+#endif // NNUE_X86
+
+//        ( AVX  XCR0)
+inline NnueSimd detectNnueSimd() {
+#if defined(NNUE_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] >> 19) & 1;
+    bool avx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 6) == 6;
+    bool avx2 = false;
+    if (avx && maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] >> 5) & 1;
+    }
+    return avx2 ? NnueSimd::AVX2 : sse41 ? NnueSimd::SSE41 : NnueSimd::SCALAR;
+#elif defined(NNUE_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return NnueSimd::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return NnueSimd::SSE41;
+    return NnueSimd::SCALAR;
+#else
+    return NnueSimd::SCALAR;
+#endif
+}
+
+inline NnueKernels nnueKernelsFor(NnueSimd simd) {
+#ifdef NNUE_X86
+    if (simd == NnueSimd::AVX2) return { updateAvx2, clipAvx2, affineAvx2 };
+    if (simd == NnueSimd::SSE41) return { updateSse41, clipSse41, affineSse41 };
+#endif
+    (void)simd;
+    return { updateScalar, clipScalar, affineScalar };
+}
+
+inline const char* nnueSimdName(NnueSimd simd) {
+    return simd == NnueSimd::AVX2 ? "AVX2" : simd == NnueSimd::SSE41 ? "SSE4.1" : "scalar";
+}
+
+#endif // NNUE_SIMD_H
@@ -0,0 +1,184 @@
+#ifndef PAWNS_H
+#define PAWNS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <memory>
+
+#include "bitboard.h"
+#include "attacks.h"
+#include "board_state.h"
+#include "psqt.h"
+
+//  : , , ,  
+//  .      -   , 
+//    , -        .
+
+//   ;    ,    
+struct CacheStats {
+    std::atomic<uint64_t> probes{ 0 };
+    std::atomic<uint64_t> hits{ 0 };
+
+    void record(bool hit) {
+        probes.store(probes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (hit) {
+            hits.store(hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    void reset() {
+        probes = 0;
+        hits = 0;
+    }
+};
+
+const PackedScore DoubledPenalty = makeScore(-10, -25);
+const PackedScore IsolatedPenalty = makeScore(-12, -15);
+const PackedScore BackwardPenalty = makeScore(-8, -12);
+
+//         
+const int PassedBonusMg[8] = { 0, 0, 5, 10, 20, 35, 60, 0 };
+const int PassedBonusEg[8] = { 0, 5, 10, 20, 40, 70, 110, 0 };
+
+// :          ,
+// 7 -   
+const int ShelterPenalty[8] = { 0, 0, -10, -20, -25, -30, -30, -35 };
+
+inline Bitboard ForwardFile[2][SQUARE_NB];
+inline Bitboard PassedMask[2][SQUARE_NB];
+inline Bitboard AdjacentFiles[8];
+
+inline bool initPawnMasks() {
+    for (int f = 0; f < 8; f++) {
+        AdjacentFiles[f] = (f > 0 ? FILE_A_BB << (f - 1) : 0) | (f < 7 ? FILE_A_BB << (f + 1) : 0);
+    }
+    for (int sq = 0; sq < SQUARE_NB; sq++) {
+        int f = sq % 8;
+        int r = sq / 8;
+        Bitboard above = r < 7 ? ~0ULL << (8 * (r + 1)) : 0;
+        Bitboard below = r > 0 ? ~0ULL >> (8 * (8 - r)) : 0;
+        ForwardFile[0][sq] = (FILE_A_BB << f) & above;
+        ForwardFile[1][sq] = (FILE_A_BB << f) & below;
+        PassedMask[0][sq] = ((FILE_A_BB << f) | AdjacentFiles[f]) & above;
+        PassedMask[1][sq] = ((FILE_A_BB << f) | AdjacentFiles[f]) & below;
+    }
+    return true;
+}
+
+inline void ensurePawnMasksInitialized() {
+    static const bool initialized = initPawnMasks();
+    (void)initialized;
+}
+
+struct PawnEntry {
+    uint64_t key;
+    PackedScore score;      //   ,  
+    Bitboard passed[2];
+    uint8_t shelterKing[2]; //      
+    int16_t shelter[2];
+};
+
+class PawnTable {
+public:
+    static const int SIZE = 8192;
+
+    CacheStats stats;
+
+    PawnTable() : entries(new PawnEntry[SIZE]) {
+        ensurePawnMasksInitialized();
+        clear();
+    }
+
+    //          ,
+    //       
+    void clear() {
+        for (int i = 0; i < SIZE; i++) {
+            entries[i] = PawnEntry();
+            entries[i].shelterKing[0] = entries[i].shelterKing[1] = 0xFF;
+        }
+    }
+
+    PawnEntry& probe(const BoardState& board) {
+        PawnEntry& e = entries[board.pawnKey & (SIZE - 1)];
+        bool hit = e.key == board.pawnKey;
+        stats.record(hit);
+        if (!hit) {
+            compute(board, e);
+        }
+        return e;
+    }
+
+    //     ,    
+    //     
+    int shelter(const BoardState& board, PawnEntry& e, int color) const {
+        int ksq = board.kingSquare(color);
+        if (e.shelterKing[color] != ksq) {
+            e.shelterKing[color] = uint8_t(ksq);
+            e.shelter[color] = int16_t(computeShelter(board, color, ksq));
+        }
+        return e.shelter[color];
+    }
+
+private:
+    std::unique_ptr<PawnEntry[]> entries;
+
+    static void compute(const BoardState& board, PawnEntry& e) {
+        e.key = board.pawnKey;
+        e.score = 0;
+        e.shelterKing[0] = e.shelterKing[1] = 0xFF;
+
+        for (int us = 0; us < 2; us++) {
+            Bitboard ours = board.plainPawns(us);
+            Bitboard theirs = board.plainPawns(us ^ 1);
+            PackedScore score = 0;
+            e.passed[us] = 0;
+
+            for (Bitboard b = ours; b; ) {
+                int sq = popLsb(b);
+                int f = sq % 8;
+                int relRank = us == 0 ? sq / 8 : 7 - sq / 8;
+                int stop = us == 0 ? std::min(sq + 8, SQUARE_NB - 1) : std::max(sq - 8, 0);
+
+                if (ForwardFile[us][sq] & ours) {
+                    score += DoubledPenalty;
+                }
+                if (!(AdjacentFiles[f] & ours)) {
+                    score += IsolatedPenalty;
+                }
+                //   ,       
+                else if (relRank < 7 && !(PassedMask[us ^ 1][stop] & AdjacentFiles[f] & ours)
+                    && (PawnAttacks[us][stop] & theirs)) {
+                    score += BackwardPenalty;
+                }
+                if (!(PassedMask[us][sq] & theirs) && !(ForwardFile[us][sq] & ours)) {
+                    e.passed[us] |= squareBB(sq);
+                    score += makeScore(PassedBonusMg[relRank], PassedBonusEg[relRank]);
+                }
+            }
+            e.score += us == 0 ? score : -score;
+        }
+    }
+
+    //      -     
+    static int computeShelter(const BoardState& board, int color, int ksq) {
+        if (ksq == NO_SQUARE) return 0;
+
+        Bitboard ours = board.plainPawns(color);
+        int center = std::min(std::max(ksq % 8, 1), 6);
+        int penalty = 0;
+        for (int f = center - 1; f <= center + 1; f++) {
+            Bitboard front = ours & (FILE_A_BB << f) & ForwardFile[color][makeSquare(f, ksq / 8)];
+            int distance = 7;
+            if (front) {
+                int sq = color == 0 ? lsb(front) : msb(front);
+                distance = std::abs(sq / 8 - ksq / 8);
+            }
+            penalty += ShelterPenalty[distance];
+        }
+        return penalty;
+    }
+};
+
+#endif // PAWNS_H
@@ -0,0 +1,184 @@
+#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "fen.h"
+#include "perft.h"
+
+//  perft   ,  GLFW  :
+//   perft <> [FEN] [--divide] [--hash <>] [--threads <N>] [--no-bulk]
+//   perft --suite [--hash <>] [--threads <N>]
+
+struct PerftReference {
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+//         ,
+//   make/test-
+const PerftReference PerftSuite[] = {
+    { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324ULL },
+    { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690ULL },
+    { "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 7, 178633661ULL },
+    { "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL },
+    { "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89941194ULL },
+    { "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 5, 164075551ULL },
+    { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN[RBNK] w KQkq - 0 1", 5, 6386507ULL },
+    { "r1b1k2r/pp[pn]p1ppp/2n5/3[RN]p3/1b2P3/2N2[BN]2/PPPP1PPP/R1B1K2R w KQkq - 0 1", 4, 1765621ULL },
+    { "4k3/1[PN]4P1/8/3q4/8/8/1p4[pr]1/R3K2R b KQ - 0 1", 5, 23809876ULL },
+};
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printSpeed(uint64_t nodes, double seconds) {
+    std::cout << "Nodes: " << nodes << std::endl;
+    std::cout << "Time:  " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+    std::cout << "NPS:   " << (uint64_t)(seconds > 0 ? nodes / seconds : 0) << std::endl;
+}
+
+// threads > 1 -  ,       
+static uint64_t runPerft(BoardState& board, int depth, PerftHash* hash, bool bulk, int threads,
+    std::vector<PerftDivideEntry>& divide) {
+    if (threads > 1) {
+        ParallelPerft parallel(threads, hash, bulk);
+        return parallel.run(board, depth, divide);
+    }
+    return perftDivide(board, depth, divide, hash, bulk);
+}
+
+static int runSuite(size_t hashMb, int threads) {
+    int failed = 0;
+    uint64_t totalNodes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const PerftReference& ref : PerftSuite) {
+        BoardState board;
+        setFen(board, ref.fen);
+
+        std::unique_ptr<PerftHash> hash;
+        if (hashMb > 0) {
+            hash.reset(new PerftHash(hashMb));
+        }
+
+        std::vector<PerftDivideEntry> divide;
+        uint64_t nodes = runPerft(board, ref.depth, hash.get(), true, threads, divide);
+        totalNodes += nodes;
+
+        bool ok = nodes == ref.nodes;
+        failed += ok ? 0 : 1;
+        std::cout << (ok ? "OK   " : "FAIL ") << "depth " << ref.depth << "  " << nodes;
+        if (!ok) std::cout << " (expected " << ref.nodes << ")";
+        std::cout << "  " << ref.fen << std::endl;
+    }
+
+    printSpeed(totalNodes, secondsSince(start));
+    std::cout << (failed ? "FAILED: " : "All passed, ") << failed << " failure(s)" << std::endl;
+    return failed ? 1 : 0;
+}
+
+static void printUsage() {
+    std::cerr << "usage: perft <depth> [fen] [--divide] [--hash <MB>] [--threads <N>] [--no-bulk]" << std::endl;
+    std::cerr << "       perft --suite [--hash <MB>] [--threads <N>]" << std::endl;
+}
+
+//      [lo, hi]; false -     
+static bool parseNumber(const char* text, long lo, long hi, long& result) {
+    char* end = nullptr;
+    errno = 0;
+    long v = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || v < lo || v > hi) {
+        return false;
+    }
+    result = v;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    ensureAttacksInitialized();
+    ensureZobristInitialized();
+
+    int depth = 0;
+    std::string fen;
+    bool divide = false;
+    bool bulk = true;
+    bool suite = false;
+    size_t hashMb = 0;
+    int threads = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--divide") divide = true;
+        else if (arg == "--no-bulk") bulk = false;
+        else if (arg == "--suite") suite = true;
+        else if (arg == "--hash" || arg == "--threads") {
+            long value = 0;
+            if (i + 1 >= argc || !parseNumber(argv[++i], 0, arg == "--hash" ? 1L << 20 : 1024, value)) {
+                std::cerr << "Invalid value for " << arg << std::endl;
+                printUsage();
+                return 2;
+            }
+            if (arg == "--hash") hashMb = size_t(value);
+            else threads = int(value);
+        }
+        else if (depth == 0 && !arg.empty() && std::isdigit((unsigned char)arg[0])) {
+            long value = 0;
+            if (!parseNumber(arg.c_str(), 1, 64, value)) {
+                std::cerr << "Invalid depth: " << arg << std::endl;
+                printUsage();
+                return 2;
+            }
+            depth = int(value);
+        }
+        else fen += (fen.empty() ? "" : " ") + arg;
+    }
+
+    // 0 -   
+    if (threads <= 0) {
+        threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (suite) {
+        return runSuite(hashMb, threads);
+    }
+
+    if (depth <= 0) {
+        printUsage();
+        return 2;
+    }
+
+    BoardState board;
+    if (!setFen(board, fen.empty() ? StartFen : fen)) {
+        std::cerr << "Invalid FEN: " << fen << std::endl;
+        return 2;
+    }
+
+    std::unique_ptr<PerftHash> hash;
+    if (hashMb > 0) {
+        hash.reset(new PerftHash(hashMb));
+    }
+
+    std::cout << getFen(board) << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PerftDivideEntry> entries;
+    uint64_t nodes = runPerft(board, depth, hash.get(), bulk, threads, entries);
+
+    if (divide) {
+        for (const PerftDivideEntry& e : entries) {
+            std::cout << moveToString(e.move) << ": " << e.nodes << std::endl;
+        }
+        std::cout << "Moves: " << entries.size() << std::endl;
+    }
+
+    printSpeed(nodes, secondsSince(start));
+    return 0;
+}
@@ -0,0 +1,258 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <random>
+
+#include "board_state.h"
+#include "movegen.h"
+
+//    :   +  ->  .
+//       :    key ^ data,
+//   ,   store,     .
+class PerftHash {
+public:
+    explicit PerftHash(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Entry) <= megabytes * 1024 * 1024) {
+            count *= 2;
+        }
+        table.reset(new Entry[count]);
+        mask = count - 1;
+    }
+
+    bool probe(uint64_t key, int depth, uint64_t& nodes) const {
+        const Entry& e = table[key & mask];
+        uint64_t data = e.data.load(std::memory_order_relaxed);
+        uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && int(data & 0xFF) == depth) {
+            nodes = data >> 8;
+            return true;
+        }
+        return false;
+    }
+
+    void store(uint64_t key, int depth, uint64_t nodes) {
+        Entry& e = table[key & mask];
+        uint64_t data = (nodes << 8) | uint64_t(depth);
+        e.check.store(key ^ data, std::memory_order_relaxed);
+        e.data.store(data, std::memory_order_relaxed);
+    }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+    };
+
+    std::unique_ptr<Entry[]> table;
+    size_t mask;
+};
+
+// bulk -     ,   
+inline uint64_t perft(BoardState& board, int depth, PerftHash* hash = nullptr, bool bulk = true) {
+    if (depth == 0) return 1;
+
+    MoveList moves;
+    generateLegalMoves(board, moves);
+    if (bulk && depth == 1) return moves.size();
+
+    uint64_t key = 0;
+    uint64_t nodes = 0;
+    if (hash != nullptr && depth > 1) {
+        key = board.key;
+        if (hash->probe(key, depth, nodes)) return nodes;
+    }
+
+    UndoRecord undo;
+    for (Move m : moves) {
+        board.make(m, undo);
+        nodes += perft(board, depth - 1, hash, bulk);
+        board.unmake(m, undo);
+    }
+
+    if (hash != nullptr && depth > 1) {
+        hash->store(key, depth, nodes);
+    }
+    return nodes;
+}
+
+struct PerftDivideEntry {
+    Move move;
+    uint64_t nodes;
+};
+
+inline uint64_t perftDivide(BoardState& board, int depth, std::vector<PerftDivideEntry>& divide,
+    PerftHash* hash = nullptr, bool bulk = true) {
+    MoveList moves;
+    generateLegalMoves(board, moves);
+
+    uint64_t total = 0;
+    UndoRecord undo;
+    for (Move m : moves) {
+        board.make(m, undo);
+        uint64_t nodes = depth > 1 ? perft(board, depth - 1, hash, bulk) : 1;
+        board.unmake(m, undo);
+        divide.push_back({ m, nodes });
+        total += nodes;
+    }
+    return total;
+}
+
+//  perft    (work stealing).
+//      ;     
+//  ,       .  
+//  ,     , 
+//    -     .
+class ParallelPerft {
+public:
+    ParallelPerft(int threadCount, PerftHash* hash, bool bulk)
+        : queues(threadCount > 0 ? threadCount : 1), hash(hash), bulk(bulk) {}
+
+    uint64_t run(const BoardState& root, int depth, std::vector<PerftDivideEntry>& divide) {
+        MoveList moves;
+        generateLegalMoves(root, moves);
+
+        results.reset(new std::atomic<uint64_t>[moves.size()]);
+        for (int i = 0; i < moves.size(); i++) {
+            results[i] = depth > 1 ? 0 : 1;
+        }
+
+        pending = 0;
+        idle = 0;
+        if (depth > 1) {
+            for (int i = 0; i < moves.size(); i++) {
+                Task task;
+                task.board = root;
+                UndoRecord undo;
+                task.board.make(moves[i], undo);
+                task.depth = depth - 1;
+                task.root = i;
+                push(i % (int)queues.size(), task);
+            }
+        }
+
+        std::vector<std::thread> threads;
+        for (int id = 1; id < (int)queues.size(); id++) {
+            threads.emplace_back(&ParallelPerft::worker, this, id);
+        }
+        worker(0);
+        for (std::thread& t : threads) {
+            t.join();
+        }
+
+        uint64_t total = 0;
+        for (int i = 0; i < moves.size(); i++) {
+            divide.push_back({ moves[i], results[i].load() });
+            total += results[i].load();
+        }
+        return total;
+    }
+
+private:
+    struct Task {
+        BoardState board;
+        int depth;
+        int root;
+    };
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    //     :    
+    static const int MIN_SPLIT_DEPTH = 3;
+
+    std::vector<Queue> queues;
+    std::unique_ptr<std::atomic<uint64_t>[]> results;
+    std::atomic<int> pending{ 0 };
+    std::atomic<int> idle{ 0 };
+    PerftHash* hash;
+    bool bulk;
+
+    void push(int id, const Task& task) {
+        pending.fetch_add(1);
+        std::lock_guard<std::mutex> lock(queues[id].mutex);
+        queues[id].tasks.push_back(task);
+    }
+
+    bool popOwn(int id, Task& task) {
+        std::lock_guard<std::mutex> lock(queues[id].mutex);
+        if (queues[id].tasks.empty()) return false;
+        task = queues[id].tasks.back();
+        queues[id].tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int id, Task& task, std::mt19937& rng) {
+        int n = (int)queues.size();
+        int start = (int)(rng() % n);
+        for (int i = 0; i < n; i++) {
+            int victim = (start + i) % n;
+            if (victim == id) continue;
+            std::lock_guard<std::mutex> lock(queues[victim].mutex);
+            if (!queues[victim].tasks.empty()) {
+                task = queues[victim].tasks.front();
+                queues[victim].tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker(int id) {
+        std::mt19937 rng(id * 7919 + 1);
+        Task task;
+        bool idling = false;
+
+        while (pending.load() > 0) {
+            if (!popOwn(id, task) && !steal(id, task, rng)) {
+                if (!idling) {
+                    idle.fetch_add(1);
+                    idling = true;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            if (idling) {
+                idle.fetch_sub(1);
+                idling = false;
+            }
+
+            if (task.depth >= MIN_SPLIT_DEPTH && idle.load() > 0) {
+                split(id, task);
+            }
+            else {
+                results[task.root] += perft(task.board, task.depth, hash, bulk);
+            }
+            pending.fetch_sub(1);
+        }
+
+        if (idling) {
+            idle.fetch_sub(1);
+        }
+    }
+
+    void split(int id, Task& task) {
+        MoveList moves;
+        generateLegalMoves(task.board, moves);
+
+        Task child;
+        child.depth = task.depth - 1;
+        child.root = task.root;
+        UndoRecord undo;
+        for (Move m : moves) {
+            child.board = task.board;
+            child.board.make(m, undo);
+            push(id, child);
+        }
+    }
+};
+
+#endif // PERFT_H
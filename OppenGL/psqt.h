@@ -0,0 +1,234 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include <cstdint>
+
+#include "bitboard.h"
+
+//       (tapered) .
+//        32- ,
+//   BoardState       .
+
+typedef int32_t PackedScore;
+
+inline PackedScore makeScore(int mg, int eg) {
+    return PackedScore(uint32_t(eg) << 16) + mg;
+}
+
+inline int mgValue(PackedScore s) {
+    return int16_t(uint16_t(uint32_t(s)));
+}
+
+inline int egValue(PackedScore s) {
+    return int16_t(uint16_t(uint32_t(s + 0x8000) >> 16));
+}
+
+// : 24 -    , 0 -  
+const int PHASE_MAX = 24;
+
+//     (32 ). 
+// ,      , 
+//       ,     - 
+//  .     setCapsValue/setCapsTable.
+struct CapsParams {
+    int mg[32];
+    int eg[32];
+    int phase[32];
+    int16_t tableMg[32][SQUARE_NB];
+    int16_t tableEg[32][SQUARE_NB];
+};
+
+inline CapsParams EvalParams;
+
+//     :  + ,  
+//     (     )
+inline PackedScore PieceSquare[PIECE_CODE_NB][SQUARE_NB];
+inline int PiecePhase[PIECE_CODE_NB];
+
+//     , a1 = 0,   
+const int8_t DefaultPawnMg[SQUARE_NB] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+     -5,   0,   0, -15, -15,   0,   0,  -5,
+     -5,  -5,   5,   5,   5,   0,  -5,  -5,
+     -5,   0,  10,  20,  20,   5,   0,  -5,
+      0,   5,  15,  25,  25,  10,   5,   0,
+     10,  15,  25,  35,  35,  25,  15,  10,
+     40,  50,  60,  70,  70,  60,  50,  40,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int8_t DefaultPawnEg[SQUARE_NB] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      5,   5,   5,   5,   5,   5,   5,   5,
+     15,  15,  15,  15,  15,  15,  15,  15,
+     30,  30,  30,  30,  30,  30,  30,  30,
+     55,  55,  55,  55,  55,  55,  55,  55,
+     90,  90,  90,  90,  90,  90,  90,  90,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+const int8_t DefaultKnight[SQUARE_NB] = {
+    -50, -35, -25, -20, -20, -25, -35, -50,
+    -35, -15,   0,   5,   5,   0, -15, -35,
+    -25,   5,  10,  15,  15,  10,   5, -25,
+    -20,   5,  15,  20,  20,  15,   5, -20,
+    -20,  10,  20,  25,  25,  20,  10, -20,
+    -25,   5,  15,  20,  20,  15,   5, -25,
+    -35, -15,   0,   5,   5,   0, -15, -35,
+    -50, -35, -25, -20, -20, -25, -35, -50
+};
+
+const int8_t DefaultBishop[SQUARE_NB] = {
+    -15, -10, -10, -10, -10, -10, -10, -15,
+    -10,  10,   5,   5,   5,   5,  10, -10,
+    -10,   5,  10,  10,  10,  10,   5, -10,
+    -10,   5,  10,  15,  15,  10,   5, -10,
+    -10,   5,  10,  15,  15,  10,   5, -10,
+    -10,   5,  10,  10,  10,  10,   5, -10,
+    -10,   0,   5,   5,   5,   5,   0, -10,
+    -15, -10, -10, -10, -10, -10, -10, -15
+};
+
+const int8_t DefaultRookMg[SQUARE_NB] = {
+      0,   0,   5,  10,  10,   5,   0,   0,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     -5,   0,   0,   0,   0,   0,   0,  -5,
+     15,  20,  20,  20,  20,  20,  20,  15,
+      0,   0,   0,   5,   5,   0,   0,   0
+};
+
+const int8_t DefaultRookEg[SQUARE_NB] = {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+     10,  10,  10,  10,  10,  10,  10,  10,
+      0,   0,   0,   0,   0,   0,   0,   0
+};
+
+//     
+const int8_t DefaultKingMg[SQUARE_NB] = {
+     20,  30,  10,   0,   0,  10,  30,  20,
+     10,  10,  -5, -10, -10,  -5,  10,  10,
+    -10, -20, -20, -25, -25, -20, -20, -10,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30
+};
+
+//     -    
+const int8_t DefaultKingStep[SQUARE_NB] = {
+    -50, -30, -20, -15, -15, -20, -30, -50,
+    -30, -10,   0,   5,   5,   0, -10, -30,
+    -20,   0,  15,  20,  20,  15,   0, -20,
+    -15,   5,  20,  30,  30,  20,   5, -15,
+    -15,   5,  20,  30,  30,  20,   5, -15,
+    -20,   0,  15,  20,  20,  15,   0, -20,
+    -30, -10,   0,   5,   5,   0, -10, -30,
+    -50, -30, -20, -15, -15, -20, -30, -50
+};
+
+//   : , , , , 
+const int DefaultCapMg[CAP_COUNT] = { 477, 365, 337, 82, 200 };
+const int DefaultCapEg[CAP_COUNT] = { 512, 297, 281, 94, 280 };
+const int DefaultCapPhase[CAP_COUNT] = { 2, 1, 1, 0, 1 };
+const int8_t* const DefaultCapTableMg[CAP_COUNT] = { DefaultRookMg, DefaultBishop, DefaultKnight, DefaultPawnMg, DefaultKingStep };
+const int8_t* const DefaultCapTableEg[CAP_COUNT] = { DefaultRookEg, DefaultBishop, DefaultKnight, DefaultPawnEg, DefaultKingStep };
+
+inline void setDefaultEvalParams() {
+    for (int caps = 1; caps < 32; caps++) {
+        int parts = 0;
+        int sumMg[SQUARE_NB] = {};
+        int sumEg[SQUARE_NB] = {};
+        EvalParams.mg[caps] = EvalParams.eg[caps] = EvalParams.phase[caps] = 0;
+
+        for (int i = 0; i < CAP_COUNT; i++) {
+            if (!(caps & (1 << i))) continue;
+            parts++;
+            EvalParams.mg[caps] += DefaultCapMg[i];
+            EvalParams.eg[caps] += DefaultCapEg[i];
+            EvalParams.phase[caps] += DefaultCapPhase[i];
+            for (int sq = 0; sq < SQUARE_NB; sq++) {
+                sumMg[sq] += DefaultCapTableMg[i][sq];
+                sumEg[sq] += DefaultCapTableEg[i][sq];
+            }
+        }
+        for (int sq = 0; sq < SQUARE_NB; sq++) {
+            EvalParams.tableMg[caps][sq] = int16_t(sumMg[sq] / parts);
+            EvalParams.tableEg[caps][sq] = int16_t(sumEg[sq] / parts);
+        }
+    }
+
+    //      
+    EvalParams.mg[CAP_ROOK | CAP_BISHOP] = 1025;
+    EvalParams.eg[CAP_ROOK | CAP_BISHOP] = 936;
+    EvalParams.phase[CAP_ROOK | CAP_BISHOP] = 4;
+
+    //  :    ,  
+    EvalParams.mg[CAP_KING] = EvalParams.eg[CAP_KING] = EvalParams.phase[CAP_KING] = 0;
+    for (int sq = 0; sq < SQUARE_NB; sq++) {
+        EvalParams.tableMg[CAP_KING][sq] = DefaultKingMg[sq];
+        EvalParams.tableEg[CAP_KING][sq] = DefaultKingStep[sq];
+    }
+}
+
+//  PieceSquare/PiecePhase  EvalParams
+inline void buildPieceSquare() {
+    for (int code = 0; code < PIECE_CODE_NB; code++) {
+        uint8_t caps = pieceCaps(PieceCode(code));
+        bool white = pieceColor(PieceCode(code)) == PieceColor::WHITE;
+        PiecePhase[code] = caps ? EvalParams.phase[caps] : 0;
+
+        for (int sq = 0; sq < SQUARE_NB; sq++) {
+            if (caps == 0) {
+                PieceSquare[code][sq] = 0;
+                continue;
+            }
+            int rel = white ? sq : sq ^ 56;
+            int mg = EvalParams.mg[caps] + EvalParams.tableMg[caps][rel];
+            int eg = EvalParams.eg[caps] + EvalParams.tableEg[caps][rel];
+            PieceSquare[code][sq] = white ? makeScore(mg, eg) : makeScore(-mg, -eg);
+        }
+    }
+}
+
+inline bool initPsqt() {
+    setDefaultEvalParams();
+    buildPieceSquare();
+    return true;
+}
+
+inline void ensurePsqtInitialized() {
+    static const bool initialized = initPsqt();
+    (void)initialized;
+}
+
+//  . BoardState      
+// :       
+// refreshEval().
+inline void setCapsValue(uint8_t caps, int mg, int eg, int phase) {
+    ensurePsqtInitialized();
+    EvalParams.mg[caps] = mg;
+    EvalParams.eg[caps] = eg;
+    EvalParams.phase[caps] = phase;
+    buildPieceSquare();
+}
+
+inline void setCapsTable(uint8_t caps, const int16_t mg[SQUARE_NB], const int16_t eg[SQUARE_NB]) {
+    ensurePsqtInitialized();
+    for (int sq = 0; sq < SQUARE_NB; sq++) {
+        EvalParams.tableMg[caps][sq] = mg[sq];
+        EvalParams.tableEg[caps][sq] = eg[sq];
+    }
+    buildPieceSquare();
+}
+
+#endif // PSQT_H
@@ -0,0 +1,887 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "board_state.h"
+#include "eval.h"
+#include "nnue.h"
+#include "movegen.h"
+#include "movepick.h"
+#include "timeman.h"
+#include "tt.h"
+
+// :   + -   .
+//       ,     :
+// start() , poll()      ,
+// stop()     .
+//
+//    Lazy SMP:       ,
+//      .   
+// ,      ,    
+//  -      .
+
+const int MAX_PLY = 128;
+const int VALUE_DRAW = 0;
+const int VALUE_MATE = 30000;
+const int VALUE_INFINITE = 31000;
+const int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+//      ,   
+inline int scoreToTT(int score, int ply) {
+    return score >= VALUE_MATE_IN_MAX_PLY ? score + ply
+        : score <= -VALUE_MATE_IN_MAX_PLY ? score - ply : score;
+}
+
+inline int scoreFromTT(int score, int ply) {
+    return score >= VALUE_MATE_IN_MAX_PLY ? score - ply
+        : score <= -VALUE_MATE_IN_MAX_PLY ? score + ply : score;
+}
+
+struct SearchLimits {
+    int depth = MAX_PLY - 1;
+    int64_t moveTime = 0;   // , 0 -  
+    uint64_t nodes = 0;     // 0 -  
+    //   , ; ,  moveTime  
+    int64_t time = 0;
+    int64_t inc = 0;
+    int movesToGo = 0;      // 0 -   
+    int64_t moveOverhead = 30;
+    //    :     ponderhit()
+    bool ponder = false;
+};
+
+//   :       
+struct PvLine {
+    int score = 0;
+    std::vector<Move> pv;
+};
+
+struct SearchInfo {
+    int depth = 0;
+    int score = 0;
+    uint64_t nodes = 0;
+    int64_t time = 0;       // 
+    Move bestMove = NO_MOVE;
+    std::vector<Move> pv;   //  ,   bestMove
+    double ebf = 0;         //   , nodes^(1/depth)
+    double pawnHitRate = 0; //    , %
+    double evalHitRate = 0; //    , %
+    int hashfull = 0;       //   , 
+    //   MultiPV   ,  -  score  pv
+    std::vector<PvLine> lines;
+};
+
+//     -    
+//       .
+struct SearchOptions {
+    bool nullMove = true;
+    bool lmr = true;
+    bool futility = true;
+    bool reverseFutility = true;
+    bool razoring = true;
+    //  ,   
+    bool nnue = true;
+    //       
+    int multiPv = 1;
+};
+
+//   :   log() * log( )
+inline int8_t Reductions[64][64];
+
+inline bool initReductions() {
+    for (int d = 1; d < 64; d++) {
+        for (int m = 1; m < 64; m++) {
+            Reductions[d][m] = int8_t(0.75 + std::log(double(d)) * std::log(double(m)) / 2.25);
+        }
+    }
+    return true;
+}
+
+inline void ensureReductionsInitialized() {
+    static const bool initialized = initReductions();
+    (void)initialized;
+}
+
+static_assert(AccumulatorStack::CAPACITY >= MAX_PLY, "AccumulatorStack is shorter than the search");
+
+//   .   -,   
+//     .
+struct alignas(64) SearchThread {
+    int id = 0;
+    BoardState board;
+    std::vector<uint64_t> keys;
+    std::atomic<uint64_t> nodes{ 0 };
+    Move rootBest = NO_MOVE;
+    int rootScore = 0;          //  rootBest   
+    std::vector<Move> rootPv;
+    int completedDepth = 0;
+    int bestScore = 0;
+    std::vector<Move> bestPv;
+    //  MultiPV  ;    
+    //   
+    std::vector<PvLine> lines;
+    std::vector<Move> rootExcluded;
+    Move rootFirst = NO_MOVE;   //       
+    bool verifying = false;
+
+    //   : pv[ply] -     
+    //  ply,        
+    Move pv[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+
+    // :    ,    
+    HistoryTable history;
+    Move killers[MAX_PLY][2];
+    Move counterMoves[PIECE_CODE_NB][SQUARE_NB];
+
+    // ,    ,    
+    struct StackEntry {
+        Move move;
+        PieceCode piece;
+    } stack[MAX_PLY];
+
+    //  :    
+    AccumulatorStack accumulators;
+
+    PawnTable pawns;
+    EvalCache evalCache;
+
+    void clearOrdering() {
+        history.clear();
+        std::memset(killers, 0, sizeof(killers));
+        std::memset(counterMoves, 0, sizeof(counterMoves));
+    }
+};
+
+//        : 
+//         ,  
+// ,     .     .
+template<typename T>
+class TripleBuffer {
+public:
+    T& back() {
+        return slots[backIndex];
+    }
+
+    void publish() {
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    const T& read() {
+        if (middle.load(std::memory_order_relaxed) & FRESH) {
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return slots[frontIndex];
+    }
+
+private:
+    static const int FRESH = 4;
+    static const int INDEX_MASK = 3;
+
+    T slots[3];
+    std::atomic<int> middle{ 1 };
+    int backIndex = 0;
+    int frontIndex = 2;
+};
+
+class Search {
+public:
+    Search() {
+        ensureReductionsInitialized();
+        ensurePsqtInitialized();
+        ensureEndgamesInitialized();
+        ensureNnueInitialized();
+        tt.resize(16);
+        setThreads(1);
+    }
+
+    ~Search() {
+        stop();
+    }
+
+    Search(const Search&) = delete;
+    Search& operator=(const Search&) = delete;
+
+    void setHashSize(size_t megabytes) {
+        stop();
+        tt.resize(megabytes);
+    }
+
+    //  :  ,       
+    void clearHash() {
+        stop();
+        tt.clear();
+        for (std::unique_ptr<SearchThread>& t : workers) {
+            t->clearOrdering();
+            t->pawns.clear();
+            t->evalCache.clear();
+        }
+    }
+
+    void setThreads(int count) {
+        stop();
+        workers.clear();
+        for (int i = 0; i < (count > 0 ? count : 1); i++) {
+            workers.emplace_back(new SearchThread());
+            workers.back()->id = i;
+            workers.back()->clearOrdering();
+        }
+    }
+
+    int threadCount() const {
+        return (int)workers.size();
+    }
+
+    void setOptions(const SearchOptions& searchOptions) {
+        stop();
+        options = searchOptions;
+    }
+
+    const SearchOptions& getOptions() const {
+        return options;
+    }
+
+    // history -     ,   
+    void start(const BoardState& root, const std::vector<uint64_t>& history, const SearchLimits& searchLimits) {
+        stop();
+
+        for (std::unique_ptr<SearchThread>& t : workers) {
+            t->board = root;
+            t->keys = history;
+            t->nodes = 0;
+            t->completedDepth = 0;
+            t->bestScore = 0;
+            t->bestPv.clear();
+            t->lines.clear();
+            t->rootExcluded.clear();
+            t->verifying = false;
+            t->accumulators.reset();
+            t->history.age();
+            std::memset(t->killers, 0, sizeof(t->killers));
+        }
+        limits = searchLimits;
+
+        //         
+        bool nnue = options.nnue && networkLoaded();
+        for (std::unique_ptr<SearchThread>& t : workers) {
+            if (nnue != useNnue) t->evalCache.clear();
+            t->pawns.stats.reset();
+            t->evalCache.stats.reset();
+        }
+        useNnue = nnue;
+        pondering = limits.ponder;
+        stopRequested = false;
+        running = true;
+        //     ,   
+        info.back() = SearchInfo();
+        info.publish();
+        thread = std::thread(&Search::run, this);
+    }
+
+    void stop() {
+        stopRequested = true;
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    bool isRunning() const {
+        return running.load();
+    }
+
+    //    :     
+    // ,    start()
+    void ponderhit() {
+        pondering = false;
+    }
+
+    bool isPondering() const {
+        return pondering.load();
+    }
+
+    //      ; 
+    //    - ,   
+    SearchInfo poll() const {
+        return info.read();
+    }
+
+private:
+    std::vector<std::unique_ptr<SearchThread>> workers;
+    SearchLimits limits;
+    SearchOptions options;
+    bool useNnue = false;
+    std::chrono::steady_clock::time_point startTime;
+    TimeManager timeManager;
+
+    TranspositionTable tt;
+    std::thread thread;
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> running{ false };
+    std::atomic<bool> pondering{ false };
+    mutable TripleBuffer<SearchInfo> info;
+
+    int64_t elapsed() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    uint64_t totalNodes() const {
+        uint64_t sum = 0;
+        for (const std::unique_ptr<SearchThread>& t : workers) {
+            sum += t->nodes.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    //       
+    void checkLimits() {
+        if (pondering.load(std::memory_order_relaxed)) return;
+        if ((timeManager.enabled() && elapsed() >= timeManager.hard())
+            || (limits.nodes && totalNodes() >= limits.nodes)) {
+            stopRequested = true;
+        }
+    }
+
+    //  :  ,     0,
+    //         
+    void run() {
+        startTime = std::chrono::steady_clock::now();
+        timeManager.init(limits.moveTime, limits.time, limits.inc, limits.movesToGo, limits.moveOverhead);
+        tt.newSearch();
+
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < workers.size(); i++) {
+            helpers.emplace_back(&Search::iterate, this, std::ref(*workers[i]));
+        }
+        iterate(*workers[0]);
+
+        stopRequested = true;
+        for (std::thread& h : helpers) {
+            h.join();
+        }
+
+        const SearchThread* best = workers[0].get();
+        for (const std::unique_ptr<SearchThread>& t : workers) {
+            if (!t->bestPv.empty() && t->completedDepth > best->completedDepth) {
+                best = t.get();
+            }
+        }
+        if (!best->lines.empty()) {
+            publish(best->completedDepth, best->lines);
+        }
+        running = false;
+    }
+
+    //    :      
+    static bool skipDepth(int id, int depth, int ply) {
+        static const int SkipSize[20] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+        static const int SkipPhase[20] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+        if (id == 0) return false;
+        int i = (id - 1) % 20;
+        return ((depth + ply + SkipPhase[i]) / SkipSize[i]) % 2 != 0;
+    }
+
+    void iterate(SearchThread& t) {
+        MoveList moves;
+        generateLegalMoves(t.board, moves);
+        if (moves.size() == 0) return;
+
+        if (t.id == 0) {
+            publish(0, { PvLine{ 0, { moves[0] } } });
+        }
+
+        // MultiPV:    K ,   
+        //   ;    
+        int pvCount = std::min(std::max(options.multiPv, 1), (int)moves.size());
+
+        for (int depth = 1; depth <= limits.depth; depth++) {
+            if (skipDepth(t.id, depth, t.board.gamePly)) continue;
+
+            std::vector<PvLine> lines;
+            t.rootExcluded.clear();
+            for (int pvIdx = 0; pvIdx < pvCount && !stopRequested; pvIdx++) {
+                int previous = t.bestScore;
+                t.rootFirst = NO_MOVE;
+                if (pvIdx < (int)t.lines.size()) {
+                    previous = t.lines[pvIdx].score;
+                    //      ,      
+                    Move m = t.lines[pvIdx].pv[0];
+                    if (std::find(t.rootExcluded.begin(), t.rootExcluded.end(), m) == t.rootExcluded.end()) {
+                        t.rootFirst = m;
+                    }
+                }
+                t.rootBest = NO_MOVE;
+                int score = aspiration(t, depth, previous);
+
+                //   ,     
+                //     
+                if (stopRequested) {
+                    if (pvIdx == 0 && t.rootBest != NO_MOVE) {
+                        lines.push_back({ t.rootScore, t.rootPv });
+                    }
+                    break;
+                }
+                lines.push_back({ score, t.rootPv });
+                t.rootExcluded.push_back(t.rootBest);
+            }
+            t.rootExcluded.clear();
+
+            if (stopRequested) {
+                //   -   
+                for (const PvLine& old : t.lines) {
+                    if ((int)lines.size() >= pvCount) break;
+                    bool reported = false;
+                    for (const PvLine& line : lines) {
+                        reported = reported || line.pv[0] == old.pv[0];
+                    }
+                    if (!reported) lines.push_back(old);
+                }
+                if (!lines.empty()) {
+                    t.lines = lines;
+                    t.bestPv = lines[0].pv;
+                }
+                break;
+            }
+
+            //        -  
+            std::stable_sort(lines.begin(), lines.end(),
+                [](const PvLine& a, const PvLine& b) { return a.score > b.score; });
+            int score = lines[0].score;
+            t.completedDepth = depth;
+            t.lines = lines;
+            t.bestScore = score;
+            t.bestPv = lines[0].pv;
+
+            if (t.id != 0) continue;
+
+            publish(depth, t.lines);
+
+            //         
+            if (timeManager.iterationDone(elapsed(), t.bestPv[0], score) && !pondering) break;
+            if (score >= VALUE_MATE_IN_MAX_PLY || score <= -VALUE_MATE_IN_MAX_PLY) break;
+        }
+    }
+
+    //     .     
+    //       .
+    int aspiration(SearchThread& t, int depth, int previous) {
+        int delta = 25;
+        int alpha = -VALUE_INFINITE;
+        int beta = VALUE_INFINITE;
+        // ,   ,     
+        if (depth >= 5 && t.completedDepth > 0) {
+            alpha = std::max(previous - delta, -VALUE_INFINITE);
+            beta = std::min(previous + delta, int(VALUE_INFINITE));
+        }
+
+        while (true) {
+            int score = alphaBeta(t, alpha, beta, depth, 0);
+            if (stopRequested) return score;
+
+            if (score <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -VALUE_INFINITE);
+            }
+            else if (score >= beta) {
+                beta = std::min(score + delta, int(VALUE_INFINITE));
+            }
+            else {
+                return score;
+            }
+            delta += delta / 2;
+        }
+    }
+
+    //    run():        
+    void publish(int depth, const std::vector<PvLine>& lines) {
+        SearchInfo& out = info.back();
+        out.depth = depth;
+        out.score = lines[0].score;
+        out.nodes = totalNodes();
+        out.time = elapsed();
+        out.bestMove = lines[0].pv.empty() ? NO_MOVE : lines[0].pv[0];
+        out.pv = lines[0].pv;
+        out.lines = lines;
+        out.ebf = depth > 0 ? std::pow(double(out.nodes), 1.0 / depth) : 0;
+        out.pawnHitRate = hitRate(&SearchThread::pawns);
+        out.evalHitRate = hitRate(&SearchThread::evalCache);
+        out.hashfull = tt.hashfull();
+        info.publish();
+    }
+
+    template<typename Cache>
+    double hitRate(Cache SearchThread::* cache) const {
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+        for (const std::unique_ptr<SearchThread>& t : workers) {
+            probes += ((*t).*cache).stats.probes.load(std::memory_order_relaxed);
+            hits += ((*t).*cache).stats.hits.load(std::memory_order_relaxed);
+        }
+        return probes ? 100.0 * hits / probes : 0;
+    }
+
+    int evaluate(SearchThread& t) const {
+        int value;
+        if (t.evalCache.probe(t.board.key, value)) {
+            return value;
+        }
+        if (useNnue) {
+            //     
+            const EndgameEntry* eg = Endgames.probe(t.board.materialKey);
+            if (eg && eg->eval) {
+                value = eg->eval(t.board, eg->strong);
+                if (t.board.sideToMove != eg->strong) value = -value;
+            }
+            else {
+                value = evaluateNnue(t.board, t.accumulators);
+                if (eg) value = value * eg->scale(t.board, eg->strong) / SCALE_NORMAL;
+            }
+        }
+        else {
+            value = ::evaluate(t.board, t.pawns);
+        }
+        t.evalCache.store(t.board.key, value);
+        return value;
+    }
+
+    //   :       
+    void makeMove(SearchThread& t, Move m, UndoRecord& undo) const {
+        t.board.make(m, undo);
+        if (useNnue) t.accumulators.push(t.board, m, undo);
+    }
+
+    void unmakeMove(SearchThread& t, Move m, const UndoRecord& undo) const {
+        t.board.unmake(m, undo);
+        if (useNnue) t.accumulators.pop();
+    }
+
+    //      ,     
+    static bool isRepetition(const SearchThread& t) {
+        int n = (int)t.keys.size();
+        for (int i = 2; i <= t.board.rule50 && i <= n; i += 2) {
+            if (t.keys[n - i] == t.board.key) return true;
+        }
+        return false;
+    }
+
+    static void updatePv(SearchThread& t, int ply, Move m) {
+        t.pv[ply][ply] = m;
+        for (int i = ply + 1; i < t.pvLength[ply + 1]; i++) {
+            t.pv[ply][i] = t.pv[ply + 1][i];
+        }
+        t.pvLength[ply] = std::max(t.pvLength[ply + 1], ply + 1);
+    }
+
+    //    :       ,
+    //    ,     - 
+    static void updateQuietStats(SearchThread& t, int ply, int depth, Move m, const Move* quiets, int quietCount) {
+        if (t.killers[ply][0] != m) {
+            t.killers[ply][1] = t.killers[ply][0];
+            t.killers[ply][0] = m;
+        }
+        if (ply > 0 && t.stack[ply - 1].move != NO_MOVE) {
+            t.counterMoves[t.stack[ply - 1].piece][toSquare(t.stack[ply - 1].move)] = m;
+        }
+
+        int bonus = depth * depth < 400 ? depth * depth * 16 : 6400;
+        t.history.update(t.stack[ply].piece, toSquare(m), bonus);
+        for (int i = 0; i < quietCount; i++) {
+            t.history.update(t.board.pieceOn(fromSquare(quiets[i])), toSquare(quiets[i]), -bonus);
+        }
+    }
+
+    //   ;      
+    void countNode(SearchThread& t) {
+        uint64_t nodes = t.nodes.load(std::memory_order_relaxed) + 1;
+        t.nodes.store(nodes, std::memory_order_relaxed);
+        if (t.id == 0 && (nodes & (TimeCheckInterval - 1)) == 0) {
+            checkLimits();
+        }
+    }
+
+    //    :   (  - 
+    // ),   SEE    .
+    int quiescence(SearchThread& t, int alpha, int beta, int ply) {
+        BoardState& board = t.board;
+        t.pvLength[ply] = ply;
+        countNode(t);
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (ply >= MAX_PLY - 1) {
+            return evaluate(t);
+        }
+
+        TTData tte;
+        Move ttMove = NO_MOVE;
+        if (tt.probe(board.key, tte)) {
+            ttMove = tte.move;
+            int ttScore = scoreFromTT(tte.score, ply);
+            if ((tte.bound == BOUND_EXACT)
+                || (tte.bound == BOUND_LOWER && ttScore >= beta)
+                || (tte.bound == BOUND_UPPER && ttScore <= alpha)) {
+                return ttScore;
+            }
+        }
+
+        bool inCheck = board.inCheck();
+        int alphaOrig = alpha;
+        int bestScore = -VALUE_INFINITE;
+        if (!inCheck) {
+            bestScore = evaluate(t);
+            if (bestScore >= beta) return bestScore;
+            if (bestScore > alpha) alpha = bestScore;
+        }
+
+        MovePicker picker(board, ttMove);
+        if (inCheck && picker.size() == 0) {
+            return -VALUE_MATE + ply;
+        }
+
+        Move bestMove = NO_MOVE;
+        UndoRecord undo;
+        for (Move m = picker.next(); m != NO_MOVE; m = picker.next()) {
+            if (!inCheck) {
+                if (isPromotion(m) && (moveFlags(m) & 3) != (FLAG_PROMO_QUEEN & 3)) continue;
+                if (see(board, m) < 0) continue;
+            }
+
+            tt.prefetch(board.keyAfter(m));
+            makeMove(t, m, undo);
+            int score = -quiescence(t, -beta, -alpha, ply + 1);
+            unmakeMove(t, m, undo);
+
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = m;
+                if (score > alpha) {
+                    alpha = score;
+                    if (alpha >= beta) break;
+                }
+            }
+        }
+
+        Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > alphaOrig ? BOUND_EXACT : BOUND_UPPER;
+        tt.store(board.key, bestMove, scoreToTT(bestScore, ply), 0, bound);
+        return bestScore;
+    }
+
+    int alphaBeta(SearchThread& t, int alpha, int beta, int depth, int ply) {
+        BoardState& board = t.board;
+        t.pvLength[ply] = ply;
+        if (ply > 0 && (board.rule50 >= 100 || isRepetition(t))) {
+            return VALUE_DRAW;
+        }
+        if (depth <= 0) {
+            return quiescence(t, alpha, beta, ply);
+        }
+
+        countNode(t);
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (ply >= MAX_PLY - 1) {
+            return evaluate(t);
+        }
+
+        bool pvNode = beta - alpha > 1;
+
+        TTData tte;
+        Move ttMove = NO_MOVE;
+        if (tt.probe(board.key, tte)) {
+            ttMove = tte.move;
+            int ttScore = scoreFromTT(tte.score, ply);
+            if (ply > 0 && tte.depth >= depth
+                && ((tte.bound == BOUND_EXACT)
+                    || (tte.bound == BOUND_LOWER && ttScore >= beta)
+                    || (tte.bound == BOUND_UPPER && ttScore <= alpha))) {
+                return ttScore;
+            }
+        }
+
+        //   MultiPV      
+        if (ply == 0 && !t.rootExcluded.empty()) {
+            ttMove = t.rootFirst;
+        }
+
+        bool inCheck = board.inCheck();
+        int staticEval = inCheck ? -VALUE_INFINITE : evaluate(t);
+        bool prunable = !pvNode && !inCheck && std::abs(beta) < VALUE_MATE_IN_MAX_PLY;
+
+        //    :      
+        //   -   
+        if (options.reverseFutility && prunable && depth <= 6
+            && staticEval - 100 * depth >= beta) {
+            return staticEval;
+        }
+
+        // :     -   
+        if (options.razoring && prunable && depth <= 2
+            && staticEval + 300 * depth <= alpha) {
+            int score = quiescence(t, alpha, alpha + 1, ply);
+            if (score <= alpha) return score;
+        }
+
+        //  :        ,
+        //  .     ,    
+        //  (  -   );   
+        //     
+        if (options.nullMove && prunable && depth >= 3 && staticEval >= beta && !t.verifying
+            && (ply == 0 || t.stack[ply - 1].move != NO_MOVE)
+            && board.hasNonPawnMaterial(board.sideToMove)) {
+            int r = 3 + depth / 4 + std::min((staticEval - beta) / 200, 3);
+
+            UndoRecord undo;
+            t.stack[ply].move = NO_MOVE;
+            t.stack[ply].piece = NO_PIECE;
+            t.keys.push_back(board.key);
+            board.makeNull(undo);
+            if (useNnue) t.accumulators.pushNull();
+            int score = -alphaBeta(t, -beta, -beta + 1, depth - 1 - r, ply + 1);
+            if (useNnue) t.accumulators.pop();
+            board.unmakeNull(undo);
+            t.keys.pop_back();
+
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+            if (score >= beta) {
+                if (score >= VALUE_MATE_IN_MAX_PLY) score = beta;
+                if (depth < 10) return score;
+
+                t.verifying = true;
+                int verified = alphaBeta(t, beta - 1, beta, depth - r, ply);
+                t.verifying = false;
+                if (verified >= beta) return score;
+            }
+        }
+
+        Move counterMove = NO_MOVE;
+        if (ply > 0 && t.stack[ply - 1].move != NO_MOVE) {
+            counterMove = t.counterMoves[t.stack[ply - 1].piece][toSquare(t.stack[ply - 1].move)];
+        }
+        MovePicker picker(board, ttMove, t.killers[ply], counterMove, t.history);
+        if (picker.size() == 0) {
+            return inCheck ? -VALUE_MATE + ply : VALUE_DRAW;
+        }
+
+        int alphaOrig = alpha;
+        int bestScore = -VALUE_INFINITE;
+        Move bestMove = NO_MOVE;
+        Move quiets[64];
+        int quietCount = 0;
+        int moveCount = 0;
+        UndoRecord undo;
+
+        for (Move m = picker.next(); m != NO_MOVE; m = picker.next()) {
+            if (ply == 0 && std::find(t.rootExcluded.begin(), t.rootExcluded.end(), m) != t.rootExcluded.end()) {
+                continue;
+            }
+
+            bool quiet = !isCapture(m) && !isPromotion(m);
+            bool searchedAny = bestScore > -VALUE_MATE_IN_MAX_PLY;
+
+            //        
+            if (!quiet && !inCheck && depth <= 3 && searchedAny
+                && see(board, m) < -100 * depth) {
+                continue;
+            }
+
+            //          
+            if (options.futility && quiet && !pvNode && !inCheck && depth <= 6 && searchedAny
+                && staticEval + 100 + 120 * depth <= alpha
+                && m != t.killers[ply][0] && m != t.killers[ply][1]) {
+                continue;
+            }
+
+            moveCount++;
+            t.stack[ply].move = m;
+            t.stack[ply].piece = board.pieceOn(fromSquare(m));
+
+            tt.prefetch(board.keyAfter(m));
+            t.keys.push_back(board.key);
+            makeMove(t, m, undo);
+
+            // PVS:    ,   - 
+            // ,    .      
+            //  .   -   - .
+            int score;
+            if (moveCount == 1) {
+                score = -alphaBeta(t, -beta, -alpha, depth - 1, ply + 1);
+            }
+            else {
+                int reduction = 0;
+                if (options.lmr && depth >= 3 && moveCount > 2 && quiet && !inCheck && !board.inCheck()) {
+                    reduction = Reductions[std::min(depth, 63)][std::min(moveCount, 63)];
+                    if (pvNode) reduction--;
+                    if (m == t.killers[ply][0] || m == t.killers[ply][1]) reduction--;
+                    reduction = std::max(0, std::min(reduction, depth - 2));
+                }
+
+                score = -alphaBeta(t, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+                if (score > alpha && reduction > 0) {
+                    score = -alphaBeta(t, -alpha - 1, -alpha, depth - 1, ply + 1);
+                }
+                if (pvNode && score > alpha && score < beta) {
+                    score = -alphaBeta(t, -beta, -alpha, depth - 1, ply + 1);
+                }
+            }
+
+            unmakeMove(t, m, undo);
+            t.keys.pop_back();
+
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                return 0;
+            }
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = m;
+                if (score > alpha) {
+                    alpha = score;
+                    if (pvNode) {
+                        updatePv(t, ply, m);
+                    }
+                    if (ply == 0) {
+                        t.rootBest = m;
+                        t.rootScore = score;
+                        t.rootPv.assign(t.pv[0], t.pv[0] + t.pvLength[0]);
+                    }
+                    if (alpha >= beta) {
+                        if (quiet) {
+                            updateQuietStats(t, ply, depth, m, quiets, quietCount);
+                        }
+                        break;
+                    }
+                }
+            }
+            if (quiet && quietCount < 64) {
+                quiets[quietCount++] = m;
+            }
+        }
+
+        //       ,     
+        if (ply == 0 && !t.rootExcluded.empty()) return bestScore;
+
+        Bound bound = bestScore >= beta ? BOUND_LOWER : bestScore > alphaOrig ? BOUND_EXACT : BOUND_UPPER;
+        tt.store(board.key, bestMove, scoreToTT(bestScore, ply), depth, bound);
+        return bestScore;
+    }
+};
+
+#endif // SEARCH_H
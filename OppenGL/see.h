@@ -0,0 +1,93 @@
+#ifndef SEE_H
+#define SEE_H
+
+#include <algorithm>
+
+#include "bitboard.h"
+#include "board_state.h"
+#include "move.h"
+
+//  ;      ,
+//       
+const int CapabilityValue[CAP_COUNT] = { 500, 330, 320, 100, 250 };
+
+inline int pieceValue(PieceCode code) {
+    uint8_t caps = pieceCaps(code);
+    if (caps == CAP_KING) return 0;
+
+    int value = 0;
+    for (int i = 0; i < CAP_COUNT; i++) {
+        if (caps & (1 << i)) value += CapabilityValue[i];
+    }
+    return value;
+}
+
+//      :    
+//   ,   .  
+//      ,  
+//    ()    -  :
+//       .
+//   .
+inline int see(const BoardState& board, Move m) {
+    int flags = moveFlags(m);
+    if (flags == FLAG_KING_CASTLE || flags == FLAG_QUEEN_CASTLE) return 0;
+
+    int from = fromSquare(m);
+    int to = toSquare(m);
+    int us = board.sideToMove;
+    PieceCode mover = board.pieceOn(from);
+    Bitboard occupied = board.occupied() ^ squareBB(from);
+
+    int gain[SQUARE_NB];
+    int d = 0;
+    gain[0] = pieceValue(board.pieceOn(to));
+    int onSquare = pieceValue(mover);
+
+    if (flags == FLAG_EP_CAPTURE) {
+        gain[0] = CapabilityValue[lsb(CAP_PAWN)];
+        occupied ^= squareBB(us == 0 ? to - 8 : to + 8);
+    }
+    else if (isPromotion(m)) {
+        onSquare = pieceValue(makePieceCode(pieceColor(mover), BoardState::promotionCaps(m)));
+        gain[0] += onSquare - pieceValue(mover);
+    }
+
+    int side = us ^ 1;
+    while (true) {
+        Bitboard attackers = board.attackersTo(to, occupied) & occupied;
+        Bitboard ours = attackers & board.byColor[side];
+        if (!ours) break;
+
+        //   ,  - 
+        int sq = NO_SQUARE;
+        int value = 0;
+        bool royal = false;
+        for (Bitboard b = ours; b; ) {
+            int s = popLsb(b);
+            bool isKing = pieceCaps(board.pieceOn(s)) == CAP_KING;
+            int v = pieceValue(board.pieceOn(s));
+            if (sq == NO_SQUARE || (royal && !isKing) || (royal == isKing && v < value)) {
+                sq = s;
+                value = v;
+                royal = isKing;
+            }
+        }
+
+        //     
+        if (royal && (attackers & board.byColor[side ^ 1])) break;
+
+        d++;
+        gain[d] = onSquare - gain[d - 1];
+        onSquare = value;
+        occupied ^= squareBB(sq);
+        side ^= 1;
+    }
+
+    while (d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        d--;
+    }
+    return gain[0];
+}
+
+#endif // SEE_H
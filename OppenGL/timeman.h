@@ -0,0 +1,87 @@
+#ifndef TIMEMAN_H
+#define TIMEMAN_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "move.h"
+
+//    .   -   
+// :     ,   
+//    ,  ,   . 
+//     ,   checkLimits.
+
+//        ,  
+const uint64_t TimeCheckInterval = 2048;
+
+class TimeManager {
+public:
+    //   ; moveTime -  ,    ,
+    //        (0 -   )
+    void init(int64_t moveTime, int64_t time, int64_t inc, int movesToGo, int64_t overhead) {
+        stableIterations = 0;
+        lastBest = NO_MOVE;
+        lastScore = 0;
+        scaled = 0;
+        flexible = false;
+
+        //    ,   checkLimits
+        if (moveTime > 0) {
+            softLimit = hardLimit = std::max<int64_t>(1, moveTime - overhead);
+            return;
+        }
+        if (time <= 0) {
+            softLimit = hardLimit = 0;
+            return;
+        }
+
+        int64_t left = std::max<int64_t>(1, time - overhead);
+        int mtg = movesToGo > 0 ? std::min(movesToGo, 50) : 40;
+        softLimit = std::min(left / mtg + inc * 3 / 4, left / 2);
+        hardLimit = std::min(softLimit * 5, left * 4 / 5);
+        softLimit = std::max<int64_t>(1, std::min(softLimit, hardLimit));
+        hardLimit = std::max<int64_t>(1, hardLimit);
+        flexible = true;
+    }
+
+    bool enabled() const {
+        return hardLimit > 0;
+    }
+
+    int64_t soft() const {
+        return scaled ? scaled : softLimit;
+    }
+
+    int64_t hard() const {
+        return hardLimit;
+    }
+
+    //  ; true -   
+    bool iterationDone(int64_t elapsed, Move best, int score) {
+        if (!enabled()) return false;
+        if (!flexible) return false;
+
+        stableIterations = best == lastBest ? stableIterations + 1 : 0;
+        //    ,  1.0  2.0 
+        double falling = lastBest == NO_MOVE ? 1.0
+            : std::min(2.0, std::max(1.0, 1.0 + (lastScore - score) / 100.0));
+        //   -   ,    - 
+        double stability = std::max(0.5, 1.5 - 0.15 * stableIterations);
+        lastBest = best;
+        lastScore = score;
+
+        scaled = std::min(hardLimit, std::max<int64_t>(1, int64_t(softLimit * falling * stability)));
+        return elapsed >= scaled;
+    }
+
+private:
+    int64_t softLimit = 0;
+    int64_t hardLimit = 0;
+    int64_t scaled = 0;
+    bool flexible = false;
+    int stableIterations = 0;
+    Move lastBest = NO_MOVE;
+    int lastScore = 0;
+};
+
+#endif // TIMEMAN_H
@@ -0,0 +1,180 @@
+#ifndef TT_H
+#define TT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+#include "move.h"
+
+//  ,     .
+//  -  64- ,    
+//    -.       
+// ;  16     XOR  
+// ,         .
+
+enum Bound : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,
+    BOUND_LOWER = 2,
+    BOUND_EXACT = BOUND_UPPER | BOUND_LOWER
+};
+
+struct TTData {
+    Move move;
+    int16_t score;
+    int8_t depth;
+    Bound bound;
+};
+
+class TranspositionTable {
+public:
+    static const int BUCKET_SIZE = 8;
+
+    TranspositionTable() {
+        resize(0);
+    }
+
+    //   ,      ;
+    //    
+    void resize(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) {
+            count *= 2;
+        }
+        table.reset(new Bucket[count]);
+        mask = count - 1;
+        generation = 0;
+    }
+
+    size_t sizeMb() const {
+        return (mask + 1) * sizeof(Bucket) / (1024 * 1024);
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; i++) {
+            for (std::atomic<uint64_t>& e : table[i].entries) {
+                e.store(0, std::memory_order_relaxed);
+            }
+        }
+        generation = 0;
+    }
+
+    //     :    
+    void newSearch() {
+        generation = (generation + 1) & GENERATION_MASK;
+    }
+
+    //    ,   
+    void prefetch(uint64_t key) const {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_prefetch(reinterpret_cast<const char*>(&table[key & mask]), _MM_HINT_T0);
+#elif defined(__GNUC__)
+        __builtin_prefetch(&table[key & mask]);
+#else
+        (void)key;
+#endif
+    }
+
+    bool probe(uint64_t key, TTData& data) const {
+        const Bucket& bucket = table[key & mask];
+        uint16_t check = uint16_t(key >> 48);
+
+        for (const std::atomic<uint64_t>& e : bucket.entries) {
+            uint64_t word = e.load(std::memory_order_relaxed);
+            if (word != 0 && entryCheck(word) == check) {
+                data.move = Move(word);
+                data.score = int16_t(word >> 16);
+                data.depth = int8_t(word >> 32);
+                data.bound = Bound((word >> 40) & 3);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, Move move, int score, int depth, Bound bound) {
+        Bucket& bucket = table[key & mask];
+        uint16_t check = uint16_t(key >> 48);
+
+        //  ,  ,       
+        std::atomic<uint64_t>* replace = nullptr;
+        uint64_t old = 0;
+        int worst = 1 << 30;
+        for (std::atomic<uint64_t>& e : bucket.entries) {
+            uint64_t word = e.load(std::memory_order_relaxed);
+            if (word == 0 || entryCheck(word) == check) {
+                replace = &e;
+                old = word;
+                break;
+            }
+            int value = int(int8_t(word >> 32)) - 8 * age(word);
+            if (value < worst) {
+                worst = value;
+                replace = &e;
+                old = word;
+            }
+        }
+
+        if (old != 0 && entryCheck(old) == check) {
+            //           
+            //     
+            if (move == NO_MOVE) {
+                move = Move(old);
+            }
+            if (bound != BOUND_EXACT && depth + 4 < int(int8_t(old >> 32))
+                && age(old) == 0) {
+                return;
+            }
+        }
+
+        uint64_t payload = uint64_t(move)
+            | (uint64_t(uint16_t(int16_t(score))) << 16)
+            | (uint64_t(uint8_t(int8_t(depth))) << 32)
+            | (uint64_t((generation << 2) | bound) << 40);
+        replace->store(payload | (uint64_t(check ^ fold(payload)) << 48), std::memory_order_relaxed);
+    }
+
+    //     ,    
+    int hashfull() const {
+        int used = 0;
+        size_t buckets = 1000 / BUCKET_SIZE < mask + 1 ? 1000 / BUCKET_SIZE : mask + 1;
+        for (size_t i = 0; i < buckets; i++) {
+            for (const std::atomic<uint64_t>& e : table[i].entries) {
+                uint64_t word = e.load(std::memory_order_relaxed);
+                used += word != 0 && age(word) == 0;
+            }
+        }
+        return int(used * 1000 / (buckets * BUCKET_SIZE));
+    }
+
+private:
+    static const unsigned GENERATION_MASK = 63;
+
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> entries[BUCKET_SIZE] = {};
+    };
+
+    std::unique_ptr<Bucket[]> table;
+    size_t mask;
+    unsigned generation;
+
+    static uint16_t fold(uint64_t payload) {
+        return uint16_t(payload ^ (payload >> 16) ^ (payload >> 32));
+    }
+
+    static uint16_t entryCheck(uint64_t word) {
+        return uint16_t(word >> 48) ^ fold(word & 0xFFFFFFFFFFFFULL);
+    }
+
+    int age(uint64_t word) const {
+        return int((generation - unsigned(word >> 42)) & GENERATION_MASK);
+    }
+};
+
+#endif // TT_H
@@ -0,0 +1,372 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fen.h"
+#include "search.h"
+
+//     UCI:        ,
+//   GUI,  GLFW  .      
+//    ;      
+// info/bestmove   .   ,   
+//    ,   stop  .
+
+class CommandQueue {
+public:
+    void push(const std::string& line) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lines.push_back(line);
+        }
+        ready.notify_one();
+    }
+
+    // waitMs < 0 -   
+    bool pop(std::string& line, int waitMs) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto hasLine = [this] { return !lines.empty(); };
+        if (waitMs < 0) {
+            ready.wait(lock, hasLine);
+        }
+        else if (!ready.wait_for(lock, std::chrono::milliseconds(waitMs), hasLine)) {
+            return false;
+        }
+        line = lines.front();
+        lines.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::string> lines;
+};
+
+static void readInput(CommandQueue& queue) {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        queue.push(line);
+        if (line == "quit") return;
+    }
+    queue.push("quit");
+}
+
+static std::string scoreToUci(int score) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) {
+        return "mate " + std::to_string((VALUE_MATE - score + 1) / 2);
+    }
+    if (score <= -VALUE_MATE_IN_MAX_PLY) {
+        return "mate -" + std::to_string((VALUE_MATE + score) / 2);
+    }
+    return "cp " + std::to_string(score);
+}
+
+//  spin-,   [lo, hi];   - 
+//  false,   
+static bool parseSpin(const std::string& name, const std::string& value, int lo, int hi, int& result) {
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    errno = 0;
+    long v = std::strtol(begin, &end, 10);
+    if (end == begin || *end != '\0' || errno == ERANGE) {
+        std::cout << "info string invalid value for " << name << std::endl;
+        return false;
+    }
+    result = int(std::min<long>(std::max<long>(v, lo), hi));
+    return true;
+}
+
+class UciEngine {
+public:
+    UciEngine() {
+        search.setThreads(1);
+        setFen(board, StartFen);
+        //  ,    GUI
+        loadNetwork(evalFile);
+    }
+
+    bool isSearching() const {
+        return searching;
+    }
+
+    // false -  
+    bool execute(const std::string& line) {
+        std::istringstream in(line);
+        std::string cmd;
+        in >> cmd;
+
+        if (cmd == "uci") {
+            std::cout << "id name OppenGL\n"
+                << "id author OppenGL team\n"
+                << "option name Hash type spin default 16 min 1 max 4096\n"
+                << "option name Threads type spin default 1 min 1 max 256\n"
+                << "option name Clear Hash type button\n"
+                << "option name Move Overhead type spin default 30 min 0 max 5000\n"
+                << "option name Ponder type check default false\n"
+                << "option name MultiPV type spin default 1 min 1 max 64\n"
+                << "option name EvalFile type string default nnue.bin\n"
+                << "option name UseNNUE type check default true\n"
+                << "option name NullMove type check default true\n"
+                << "option name LMR type check default true\n"
+                << "option name Futility type check default true\n"
+                << "option name ReverseFutility type check default true\n"
+                << "option name Razoring type check default true\n"
+                << "uciok" << std::endl;
+        }
+        else if (cmd == "isready") {
+            std::cout << "readyok" << std::endl;
+        }
+        else if (cmd == "ucinewgame") {
+            search.clearHash();
+        }
+        else if (cmd == "setoption") {
+            setOption(in);
+        }
+        else if (cmd == "position") {
+            position(in);
+        }
+        else if (cmd == "go") {
+            go(in);
+        }
+        else if (cmd == "stop") {
+            search.stop();
+            waitForStop = false;
+        }
+        else if (cmd == "ponderhit") {
+            search.ponderhit();
+            waitForStop = infinite;
+        }
+        else if (cmd == "quit") {
+            search.stop();
+            return false;
+        }
+        else if (cmd == "d") {
+            std::cout << getFen(board) << std::endl;
+        }
+        else if (!cmd.empty()) {
+            std::cout << "info string unknown command " << cmd << std::endl;
+        }
+        return true;
+    }
+
+    //   -  info;    bestmove,
+    //   ponder  infinite    stop  ponderhit
+    void update() {
+        if (!searching) return;
+
+        bool finished = !search.isRunning();
+        SearchInfo info = search.poll();
+        if (info.depth > reportedDepth) {
+            reportedDepth = info.depth;
+            printInfo(info);
+        }
+        if (!finished || waitForStop) return;
+        finishSearch();
+    }
+
+private:
+    Search search;
+    BoardState board;
+    std::vector<uint64_t> history;
+    std::string evalFile = "nnue.bin";
+    int64_t moveOverhead = 30;
+
+    bool searching = false;
+    bool waitForStop = false;
+    bool infinite = false;
+    int reportedDepth = 0;
+
+    //  go -   bestmove
+    void finishSearch() {
+        search.stop();
+        searching = false;
+        SearchInfo info = search.poll();
+        std::cout << "bestmove " << moveToString(info.bestMove);
+        if (info.pv.size() > 1) {
+            std::cout << " ponder " << moveToString(info.pv[1]);
+        }
+        std::cout << std::endl;
+    }
+
+    //      MultiPV
+    void printInfo(const SearchInfo& info) {
+        for (size_t i = 0; i < info.lines.size(); i++) {
+            std::cout << "info depth " << info.depth << " multipv " << i + 1
+                << " score " << scoreToUci(info.lines[i].score)
+                << " nodes " << info.nodes << " nps " << (info.time > 0 ? info.nodes * 1000 / info.time : info.nodes)
+                << " time " << info.time << " hashfull " << info.hashfull << " pv";
+            for (Move m : info.lines[i].pv) {
+                std::cout << " " << moveToString(m);
+            }
+            std::cout << "\n";
+        }
+        std::cout << std::flush;
+    }
+
+    // setoption name <   > [value <>]
+    void setOption(std::istringstream& in) {
+        std::string token, name, value;
+        in >> token;
+        while (in >> token && token != "value") {
+            name += (name.empty() ? "" : " ") + token;
+        }
+        while (in >> token) {
+            value += (value.empty() ? "" : " ") + token;
+        }
+
+        //   ,     uci
+        int spin = 0;
+        if (name == "Hash") {
+            if (parseSpin(name, value, 1, 4096, spin)) search.setHashSize(spin);
+            return;
+        }
+        if (name == "Threads") {
+            if (parseSpin(name, value, 1, 256, spin)) search.setThreads(spin);
+            return;
+        }
+        if (name == "Clear Hash") {
+            search.clearHash();
+            return;
+        }
+        //      GUI,     
+        if (name == "Move Overhead") {
+            if (parseSpin(name, value, 0, 5000, spin)) moveOverhead = spin;
+            return;
+        }
+        // ponder   GUI,     
+        if (name == "Ponder") {
+            return;
+        }
+        if (name == "EvalFile") {
+            search.stop();
+            evalFile = value;
+            std::cout << "info string " << (loadNetwork(evalFile) ? "loaded " : "cannot load ") << evalFile << std::endl;
+            return;
+        }
+
+        SearchOptions options = search.getOptions();
+        bool on = value == "true";
+        if (name == "MultiPV") {
+            if (!parseSpin(name, value, 1, 64, spin)) return;
+            options.multiPv = spin;
+        }
+        else if (name == "UseNNUE") options.nnue = on;
+        else if (name == "NullMove") options.nullMove = on;
+        else if (name == "LMR") options.lmr = on;
+        else if (name == "Futility") options.futility = on;
+        else if (name == "ReverseFutility") options.reverseFutility = on;
+        else if (name == "Razoring") options.razoring = on;
+        else {
+            std::cout << "info string unknown option " << name << std::endl;
+            return;
+        }
+        search.setOptions(options);
+    }
+
+    // position startpos|fen <FEN> [moves <>...]
+    void position(std::istringstream& in) {
+        std::string token, fen;
+        in >> token;
+        if (token == "startpos") {
+            fen = StartFen;
+            in >> token;
+        }
+        else if (token == "fen") {
+            while (in >> token && token != "moves") {
+                fen += (fen.empty() ? "" : " ") + token;
+            }
+        }
+        else {
+            return;
+        }
+
+        BoardState next;
+        if (!setFen(next, fen)) {
+            std::cout << "info string invalid fen " << fen << std::endl;
+            return;
+        }
+        board = next;
+        history.clear();
+
+        UndoRecord undo;
+        while (in >> token) {
+            Move m = parseMove(board, token);
+            if (m == NO_MOVE) {
+                std::cout << "info string illegal move " << token << std::endl;
+                break;
+            }
+            history.push_back(board.key);
+            board.make(m, undo);
+        }
+    }
+
+    void go(std::istringstream& in) {
+        // go   :     
+        if (searching) {
+            finishSearch();
+        }
+
+        SearchLimits limits;
+        int64_t time[2] = { 0, 0 };
+        int64_t inc[2] = { 0, 0 };
+        int movesToGo = 0;
+        infinite = false;
+
+        std::string token;
+        while (in >> token) {
+            if (token == "wtime") in >> time[0];
+            else if (token == "btime") in >> time[1];
+            else if (token == "winc") in >> inc[0];
+            else if (token == "binc") in >> inc[1];
+            else if (token == "movestogo") in >> movesToGo;
+            else if (token == "movetime") in >> limits.moveTime;
+            else if (token == "depth") in >> limits.depth;
+            else if (token == "nodes") in >> limits.nodes;
+            else if (token == "infinite") infinite = true;
+            else if (token == "ponder") limits.ponder = true;
+        }
+        limits.depth = std::min(std::max(limits.depth, 1), MAX_PLY - 1);
+
+        //    ,      
+        limits.time = time[board.sideToMove];
+        limits.inc = inc[board.sideToMove];
+        limits.movesToGo = movesToGo;
+        limits.moveOverhead = moveOverhead;
+
+        search.start(board, history, limits);
+        searching = true;
+        waitForStop = infinite || limits.ponder;
+        reportedDepth = 0;
+    }
+};
+
+int main() {
+    ensureAttacksInitialized();
+    ensureZobristInitialized();
+    std::ios::sync_with_stdio(false);
+
+    UciEngine engine;
+    CommandQueue queue;
+    std::thread input(readInput, std::ref(queue));
+
+    std::string line;
+    while (true) {
+        if (queue.pop(line, engine.isSearching() ? 1 : -1) && !engine.execute(line)) {
+            break;
+        }
+        engine.update();
+    }
+
+    input.join();
+    return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+#include "bitboard.h"
+
+// xorshift64*, :      
+struct PRNG {
+    uint64_t s;
+
+    explicit PRNG(uint64_t seed) : s(seed) {}
+
+    uint64_t next() {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 2685821657736338717ULL;
+    }
+};
+
+struct ZobristKeys {
+    uint64_t psq[PIECE_CODE_NB][SQUARE_NB];
+    // material[][i] -  i-     
+    uint64_t material[PIECE_CODE_NB][SQUARE_NB];
+    uint64_t castling[16];
+    uint64_t epFile[8];
+    uint64_t side;
+};
+
+inline ZobristKeys Zobrist;
+
+inline bool initZobrist() {
+    PRNG rng(1070372);
+    for (int code = 0; code < PIECE_CODE_NB; code++) {
+        for (int sq = 0; sq < SQUARE_NB; sq++) {
+            Zobrist.psq[code][sq] = rng.next();
+        }
+    }
+    for (int i = 0; i < 16; i++) {
+        Zobrist.castling[i] = rng.next();
+    }
+    for (int f = 0; f < 8; f++) {
+        Zobrist.epFile[f] = rng.next();
+    }
+    Zobrist.side = rng.next();
+    for (int code = 0; code < PIECE_CODE_NB; code++) {
+        for (int i = 0; i < SQUARE_NB; i++) {
+            Zobrist.material[code][i] = rng.next();
+        }
+    }
+    //        -    
+    Zobrist.castling[0] = 0;
+    return true;
+}
+
+inline void ensureZobristInitialized() {
+    static const bool initialized = initZobrist();
+    (void)initialized;
+}
+
+#endif // ZOBRIST_H